@@ -1,6 +1,20 @@
 #include <algorithm>
+#include <array>
+#include <charconv>
 #include <cstdlib>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <numeric>
 #include <random>
+#include <shared_mutex>
+#include <span>
+#include <string>
+#include <string_view>
+#include <thread>
+#include <tuple>
+#include <unordered_map>
+#include <variant>
 #include <vector>
 
 #include <benchmark/benchmark.h>
@@ -8,27 +22,156 @@
 #include <cstdlib>
 #include <cstring>
 #include <limits>
+#include <list>
+#include <map>
 #include <ranges>
+#ifdef __linux__
+#include <pthread.h>
+#include <sched.h>
+#include <sys/resource.h>
+#endif
 #include "ranges.h"
 
 // #pragma GCC target("avx512f")
 // #include <x86intrin.h>
 
-static std::mt19937 gen{42};
+// Datasets
 
-std::vector<uint64_t> generate(size_t size) {
-  std::vector<uint64_t> vec(size);
-  std::uniform_int_distribution<uint64_t> dist(
-      0, std::numeric_limits<uint64_t>::max());
-  std::generate(vec.begin(), vec.end(), [&]() { return dist(gen); });
-  return vec;
+// Every (size, distribution, seed) is generated once and shared by all the
+// benchmarks until one that is done with it releases it. Element i depends
+// only on the seed and i, so generation runs in parallel and a benchmark
+// sees the same data whatever runs before it.
+// Setting RANGES_DATASET_DIR keeps generated datasets on disk between runs.
+
+enum Distribution { DSUniform, DSSmallRange, DSSorted };
+
+static constexpr uint64_t kSeed = 42;
+
+// SplitMix64 finalizer over a counter
+static uint64_t SplitMix(uint64_t seed, uint64_t index) {
+  uint64_t z = seed + (index + 1) * 0x9e3779b97f4a7c15ULL;
+  z = (z ^ (z >> 30)) * 0xbf58476d1ce4e5b9ULL;
+  z = (z ^ (z >> 27)) * 0x94d049bb133111ebULL;
+  return z ^ (z >> 31);
+}
+
+// Uniform over all of uint64_t, below 4096, or sorted with small gaps like
+// timestamps or ids
+static void Generate(std::vector<uint64_t>& data, Distribution distribution,
+                     uint64_t seed) {
+  size_t workers = std::max(1U, std::thread::hardware_concurrency());
+  size_t chunk = (data.size() + workers - 1) / workers;
+  std::vector<std::thread> threads;
+  for (size_t begin = 0; begin < data.size(); begin += chunk) {
+    threads.emplace_back([&, begin] {
+      size_t end = std::min(begin + chunk, data.size());
+      for (size_t i = begin; i < end; ++i) {
+        data[i] = SplitMix(seed, i);
+      }
+      if (distribution != DSUniform) {
+        for (size_t i = begin; i < end; ++i) {
+          data[i] %= 4096;
+        }
+      }
+    });
+  }
+  for (auto&& thread : threads) {
+    thread.join();
+  }
+  if (distribution == DSSorted) {
+    uint64_t sum = 0;
+    for (auto&& num : data) {
+      num = sum += num % 64;
+    }
+  }
+}
+
+static std::string DatasetPath(size_t size, Distribution distribution,
+                               uint64_t seed) {
+  char const* dir = std::getenv("RANGES_DATASET_DIR");
+  if (dir == nullptr) {
+    return {};
+  }
+  return std::string(dir) + "/ranges-" + std::to_string(distribution) + "-" +
+         std::to_string(size) + "-" + std::to_string(seed) + ".bin";
+}
+
+static bool Load(std::string const& path, std::vector<uint64_t>& data) {
+  std::FILE* file = std::fopen(path.c_str(), "rb");
+  if (file == nullptr) {
+    return false;
+  }
+  size_t read = std::fread(data.data(), sizeof(uint64_t), data.size(), file);
+  std::fclose(file);
+  return read == data.size();
+}
+
+static void Store(std::string const& path, std::vector<uint64_t> const& data) {
+  std::FILE* file = std::fopen(path.c_str(), "wb");
+  if (file == nullptr) {
+    return;
+  }
+  size_t written =
+      std::fwrite(data.data(), sizeof(uint64_t), data.size(), file);
+  std::fclose(file);
+  if (written != data.size()) {
+    std::remove(path.c_str());
+  }
+}
+
+using DatasetKey = std::tuple<size_t, Distribution, uint64_t>;
+
+static std::mutex dataset_mutex;
+static std::map<DatasetKey, std::unique_ptr<std::vector<uint64_t> const>>
+    datasets;
+
+static std::vector<uint64_t> const& Dataset(
+    size_t size, Distribution distribution = DSUniform, uint64_t seed = kSeed) {
+  std::lock_guard lock{dataset_mutex};
+  auto&& dataset = datasets[DatasetKey{size, distribution, seed}];
+  if (!dataset) {
+    auto data = std::make_unique<std::vector<uint64_t>>(size);
+    auto path = DatasetPath(size, distribution, seed);
+    if (path.empty() || !Load(path, *data)) {
+      Generate(*data, distribution, seed);
+      if (!path.empty()) {
+        Store(path, *data);
+      }
+    }
+    dataset = std::move(data);
+  }
+  return *dataset;
+}
+
+// Frees a dataset that no running benchmark refers to any more, the next
+// Dataset call generates or loads it again
+static void ReleaseDataset(size_t size, Distribution distribution = DSUniform,
+                           uint64_t seed = kSeed) {
+  std::lock_guard lock{dataset_mutex};
+  datasets.erase(DatasetKey{size, distribution, seed});
+}
+
+// Datasets from this size on take hundreds of megabytes, at most one of them
+// is kept between runs
+constexpr size_t kLargeDataset = 10000000;
+
+static void KeepLargeDataset(DatasetKey const& keep) {
+  std::lock_guard lock{dataset_mutex};
+  std::erase_if(datasets, [&](auto const& entry) {
+    return std::get<0>(entry.first) >= kLargeDataset && entry.first != keep;
+  });
+}
+
+// Setup of families over uniform datasets of the first argument's size
+static void LargeDatasetSetup(const benchmark::State& state) {
+  KeepLargeDataset(DatasetKey{state.range(0), DSUniform, kSeed});
 }
 
 enum FilterCollect { FCStl, FCStorm, FCSimple };
 
 static void BM_FilterCollect(benchmark::State& state) {
   size_t size = state.range(0);
-  auto data = generate(size);
+  auto& data = Dataset(size);
 
   for (auto _ : state) {
     switch (state.range(1)) {
@@ -64,7 +207,7 @@ enum FilterMapCollect { FMCStl, FMCStormOptimized, FMCStorm };
 
 static void BM_FilterMapCollect(benchmark::State& state) {
   size_t size = state.range(0);
-  auto data = generate(size);
+  auto& data = Dataset(size);
 
   for (auto _ : state) {
     switch (state.range(1)) {
@@ -100,7 +243,7 @@ static void BM_FilterMapCollect(benchmark::State& state) {
 
 static void BM_MapFilterCollect(benchmark::State& state) {
   size_t size = state.range(0);
-  auto data = generate(size);
+  auto& data = Dataset(size);
 
   for (auto _ : state) {
     switch (state.range(1)) {
@@ -135,6 +278,1300 @@ static void BM_MapFilterCollect(benchmark::State& state) {
   }
 }
 
+enum DeepPipeline { DPStl, DPStorm };
+
+static auto FilterMapFilter(std::vector<uint64_t> const& data) {
+  return View{data}                                               //
+         | ranges::Filter([](auto&& num) { return num % 2 == 0; })  //
+         | ranges::Map([](auto&& num) { return num / 2; })          //
+         | ranges::Filter([](auto&& num) { return num % 3 != 0; });
+}
+
+// operator| fuses the stages into one FilterMap that keeps its position, the
+// end and the current value
+using DeepView =
+    decltype(FilterMapFilter(std::declval<std::vector<uint64_t> const&>()));
+using DeepIterator = decltype(std::declval<DeepView&>().begin());
+using DeepSentinel = decltype(std::declval<DeepView&>().end());
+static_assert(sizeof(DeepIterator) ==
+              2 * sizeof(uint64_t*) + sizeof(std::optional<uint64_t>));
+static_assert(sizeof(DeepSentinel) == sizeof(uint64_t*));
+
+static void BM_DeepPipelineCollect(benchmark::State& state) {
+  size_t size = state.range(0);
+  auto& data = Dataset(size);
+
+  for (auto _ : state) {
+    switch (state.range(1)) {
+      case DPStorm:
+        benchmark::DoNotOptimize(
+            FilterMapFilter(data)                                      //
+            | ranges::Map([](auto&& num) { return num * 3; })          //
+            | ranges::Filter([](auto&& num) { return num % 5 != 0; })  //
+            | ranges::Collect<>{});
+        break;
+      case DPStl:
+        benchmark::DoNotOptimize(
+            data                                                           //
+            | std::views::filter([](auto&& num) { return num % 2 == 0; })  //
+            | std::views::transform([](auto&& num) { return num / 2; })    //
+            | std::views::filter([](auto&& num) { return num % 3 != 0; })  //
+            | std::views::transform([](auto&& num) { return num * 3; })    //
+            | std::views::filter([](auto&& num) { return num % 5 != 0; })  //
+            | std::ranges::to<std::vector<uint64_t>>());
+        break;
+    }
+  }
+}
+
+enum LargeCapture { LCStl, LCStorm, LCSimple };
+
+static std::array<uint64_t, 1024> MakeTable() {
+  std::array<uint64_t, 1024> table{};
+  auto& data = Dataset(table.size(), DSUniform, kSeed + 1);
+  std::copy(data.begin(), data.end(), table.begin());
+  return table;
+}
+
+// Predicates capture an 8 KiB lookup table by value
+static void BM_LargeCaptureFilterMapCollect(benchmark::State& state) {
+  size_t size = state.range(0);
+  auto& data = Dataset(size);
+  auto table = MakeTable();
+  auto pred = [table](auto&& num) { return table[num % 1024] % 2 == 0; };
+  auto op = [table](auto&& num) { return num ^ table[num % 1024]; };
+
+  for (auto _ : state) {
+    switch (state.range(1)) {
+      case LCStorm:
+        benchmark::DoNotOptimize(View{data}           //
+                                 | ranges::Filter(pred)  //
+                                 | ranges::Map(op)       //
+                                 | ranges::Collect<>{});
+        break;
+      case LCStl:
+        benchmark::DoNotOptimize(data                        //
+                                 | std::views::filter(pred)  //
+                                 | std::views::transform(op)  //
+                                 | std::ranges::to<std::vector<uint64_t>>());
+        break;
+      case LCSimple: {
+        std::vector<uint64_t> n;
+        for (auto&& num : data) {
+          if (pred(num)) {
+            n.emplace_back(op(num));
+          }
+        }
+        benchmark::DoNotOptimize(n);
+      } break;
+    }
+  }
+}
+
+// Stands for a costly per-element transformation
+static uint64_t Expensive(uint64_t num) {
+  for (int round = 0; round < 16; ++round) {
+    num ^= num >> 31;
+    num *= 0x9e3779b97f4a7c15ULL;
+  }
+  return num;
+}
+
+enum CacheMode { CMPlain, CMCache, CMBlockCache };
+
+static void BM_CacheRepeat(benchmark::State& state) {
+  size_t size = state.range(0);
+  auto& data = Dataset(size);
+  auto map = ranges::Map([](auto&& num) { return Expensive(num); });
+
+  for (auto _ : state) {
+    switch (state.range(1)) {
+      case CMPlain:
+        benchmark::DoNotOptimize(View{data} | map | ranges::Repeat(8)  //
+                                 | ranges::Collect<>{});
+        break;
+      case CMCache:
+        benchmark::DoNotOptimize(View{data} | map | ranges::Cache{}  //
+                                 | ranges::Repeat(8) | ranges::Collect<>{});
+        break;
+      case CMBlockCache:
+        benchmark::DoNotOptimize(View{data} | map | ranges::Cache{1024}  //
+                                 | ranges::Repeat(8) | ranges::Collect<>{});
+        break;
+    }
+  }
+}
+
+// Len, Max, Min and Equal each traverse the pipeline
+template <typename Range>
+static void MultiPass(Range&& range) {
+  benchmark::DoNotOptimize(Len(range));
+  benchmark::DoNotOptimize(Max(range));
+  benchmark::DoNotOptimize(Min(range));
+  benchmark::DoNotOptimize(Equal(range, range));
+}
+
+static void BM_CacheMultiPass(benchmark::State& state) {
+  size_t size = state.range(0);
+  auto& data = Dataset(size);
+  auto map = ranges::Map([](auto&& num) { return Expensive(num); });
+
+  for (auto _ : state) {
+    switch (state.range(1)) {
+      case CMPlain:
+        MultiPass(View{data} | map);
+        break;
+      case CMCache:
+        MultiPass(View{data} | map | ranges::Cache{});
+        break;
+      case CMBlockCache:
+        MultiPass(View{data} | map | ranges::Cache{1024});
+        break;
+    }
+  }
+}
+
+enum SnapshotMode { SMEpoch, SMSharedMutex };
+
+static std::unique_ptr<SnapshotSource<uint64_t>> snapshot;
+static std::vector<uint64_t> locked;
+static std::shared_mutex locked_mutex;
+
+static void SnapshotSetup(const benchmark::State& state) {
+  snapshot =
+      std::make_unique<SnapshotSource<uint64_t>>(Dataset(state.range(0)));
+  locked = Dataset(state.range(0));
+}
+
+static void SnapshotTeardown(const benchmark::State&) {
+  snapshot.reset();
+  locked = {};
+}
+
+// Thread 0 publishes new versions while the other threads read
+static void BM_SnapshotReaders(benchmark::State& state) {
+  size_t size = state.range(0);
+  auto even = [](auto&& num) { return num % 2 == 0; };
+
+  if (state.thread_index() == 0) {
+    auto& next = Dataset(size, DSUniform, kSeed + 1);
+    for (auto _ : state) {
+      switch (state.range(1)) {
+        case SMEpoch:
+          snapshot->Publish(next);
+          break;
+        case SMSharedMutex: {
+          auto copy = next;
+          std::unique_lock lock{locked_mutex};
+          locked.swap(copy);
+        } break;
+      }
+    }
+    return;
+  }
+
+  auto reader = snapshot->Register();
+  for (auto _ : state) {
+    switch (state.range(1)) {
+      case SMEpoch:
+        benchmark::DoNotOptimize(Fold(reader->Pin() | ranges::Filter(even),
+                                      uint64_t{0}, std::plus<>{}));
+        break;
+      case SMSharedMutex: {
+        std::shared_lock lock{locked_mutex};
+        benchmark::DoNotOptimize(Fold(View{locked} | ranges::Filter(even),
+                                      uint64_t{0}, std::plus<>{}));
+      } break;
+    }
+  }
+  state.SetItemsProcessed(state.iterations() * size);
+}
+
+enum GeneratorSource { GSVector, GSElement, GSBatch, GSAsync };
+
+static Generator<uint64_t> Elements(std::vector<uint64_t> const& data) {
+  for (auto&& num : data) {
+    co_yield num;
+  }
+}
+
+static Generator<uint64_t> Batches(std::vector<uint64_t> const& data,
+                                   size_t batch) {
+  std::span<uint64_t const> all{data};
+  for (size_t i = 0; i < all.size(); i += batch) {
+    co_yield all.subspan(i, std::min(batch, all.size() - i));
+  }
+}
+
+static AsyncGenerator<uint64_t> Received(std::vector<uint64_t> const& data,
+                                         size_t batch) {
+  for (size_t i = 0; i < data.size(); i += batch) {
+    auto last = data.begin() + std::min(i + batch, data.size());
+    co_yield std::vector<uint64_t>(data.begin() + i, last);
+  }
+}
+
+static void BM_GeneratorFilterCollect(benchmark::State& state) {
+  size_t size = state.range(0);
+  auto& data = Dataset(size);
+  auto even = ranges::Filter([](auto&& num) { return num % 2 == 0; });
+  ThreadPool pool{1};
+
+  for (auto _ : state) {
+    switch (state.range(1)) {
+      case GSVector:
+        benchmark::DoNotOptimize(View{data} | even | ranges::Collect<>{});
+        break;
+      case GSElement:
+        benchmark::DoNotOptimize(Elements(data) | even | ranges::Collect<>{});
+        break;
+      case GSBatch:
+        benchmark::DoNotOptimize(Batches(data, 1024) | even  //
+                                 | ranges::Collect<>{});
+        break;
+      case GSAsync:
+        benchmark::DoNotOptimize(
+            SyncWait(ranges::CollectAsync(Received(data, 1024), pool, even)));
+        break;
+    }
+  }
+  state.SetItemsProcessed(state.iterations() * size);
+}
+
+enum BitmapQuery { BQFilter, BQCold, BQWarm };
+
+// Filters the same column by two predicates, as a dashboard query would
+static void BM_BitmapFilterCollect(benchmark::State& state) {
+  size_t size = state.range(0);
+  auto& data = Dataset(size);
+  auto even = [](auto&& num) { return num % 2 == 0; };
+  auto three = [](auto&& num) { return num % 3 == 0; };
+  BitmapCache cache;
+
+  for (auto _ : state) {
+    switch (state.range(1)) {
+      case BQFilter:
+        benchmark::DoNotOptimize(View{data}              //
+                                 | ranges::Filter(even)   //
+                                 | ranges::Filter(three)  //
+                                 | ranges::Collect<>{});
+        break;
+      case BQCold:
+        cache.Clear();
+        [[fallthrough]];
+      case BQWarm: {
+        // The dataset never changes, a single version covers it
+        auto bitmap = *cache.Get(View{data}, even, 0) &
+                      *cache.Get(View{data}, three, 0);
+        benchmark::DoNotOptimize(View{data}                           //
+                                 | ranges::FilterBy(std::move(bitmap))  //
+                                 | ranges::Collect<>{});
+      } break;
+    }
+  }
+}
+
+enum ExtremaSource { ESView, ESMapView };
+enum Extrema { EXNaive, EXMax, EXMinMax, EXArgMax, EXParallelMax };
+
+// Keeps the best iterator and dereferences it again for every comparison
+template <typename Range>
+static GetValueType<Range> NaiveMax(Range&& range) {
+  auto best = std::begin(range);
+  for (auto it = best, end = std::end(range); it != end; ++it) {
+    if (*best < *it) {
+      best = it;
+    }
+  }
+  return *best;
+}
+
+template <typename Range>
+static void RunExtrema(benchmark::State& state, Range&& range) {
+  static ThreadPool pool;
+  switch (state.range(2)) {
+    case EXNaive:
+      benchmark::DoNotOptimize(NaiveMax(range));
+      break;
+    case EXMax:
+      benchmark::DoNotOptimize(Max(range));
+      break;
+    case EXMinMax:
+      benchmark::DoNotOptimize(MinMax(range));
+      break;
+    case EXArgMax:
+      benchmark::DoNotOptimize(ArgMax(range));
+      break;
+    case EXParallelMax:
+      benchmark::DoNotOptimize(Max(ranges::Parallel{pool}, range));
+      break;
+  }
+}
+
+static void BM_Extrema(benchmark::State& state) {
+  size_t size = state.range(0);
+  auto& data = Dataset(size);
+  auto map = ranges::Map([](auto&& num) { return Expensive(num); });
+
+  for (auto _ : state) {
+    switch (state.range(1)) {
+      case ESView:
+        RunExtrema(state, View{data});
+        break;
+      case ESMapView:
+        RunExtrema(state, View{data} | map);
+        break;
+    }
+  }
+}
+
+enum CompareSource { CSView, CSFilter };
+enum Compare { CPNaive, CPEqual, CPMismatch, CPLexCompare };
+
+// Equal as it was, both lengths first and then a second walk
+template <typename RngL, typename RngR>
+static bool NaiveEqual(RngL&& lhs, RngR&& rhs) {
+  if (Len(lhs) != Len(rhs)) {
+    return false;
+  }
+  auto rit = rhs.begin();
+  for (auto it = lhs.begin(), end = lhs.end(); it != end; ++it, ++rit) {
+    if (!(*it == *rit)) {
+      return false;
+    }
+  }
+  return true;
+}
+
+template <typename RngL, typename RngR>
+static void RunCompare(benchmark::State& state, RngL&& lhs, RngR&& rhs) {
+  switch (state.range(2)) {
+    case CPNaive:
+      benchmark::DoNotOptimize(NaiveEqual(lhs, rhs));
+      break;
+    case CPEqual:
+      benchmark::DoNotOptimize(Equal(lhs, rhs));
+      break;
+    case CPMismatch:
+      benchmark::DoNotOptimize(Mismatch(lhs, rhs));
+      break;
+    case CPLexCompare:
+      benchmark::DoNotOptimize(LexCompare(lhs, rhs));
+      break;
+  }
+}
+
+// Equal inputs, every comparison has to walk to the end
+static void BM_Compare(benchmark::State& state) {
+  size_t size = state.range(0);
+  auto& data = Dataset(size);
+  auto copy = data;
+  auto filter = ranges::Filter([](auto&& num) { return num % 3 != 0; });
+
+  for (auto _ : state) {
+    switch (state.range(1)) {
+      case CSView:
+        RunCompare(state, View{data}, View{copy});
+        break;
+      case CSFilter:
+        RunCompare(state, View{data} | filter, View{copy} | filter);
+        break;
+    }
+  }
+}
+
+enum SizeSource { SSListMap, SSFilterTake, SSRepeatMap };
+enum SizeQuery { SQWalk, SQLen, SQCollect };
+
+// Walk is what Len did before size hints
+template <typename Range>
+static void RunSizeQuery(benchmark::State& state, Range&& range) {
+  switch (state.range(2)) {
+    case SQWalk:
+      benchmark::DoNotOptimize(Distance(range.begin(), range.end()));
+      break;
+    case SQLen:
+      benchmark::DoNotOptimize(Len(range));
+      break;
+    case SQCollect:
+      benchmark::DoNotOptimize(range | ranges::Collect<>{});
+      break;
+  }
+}
+
+static void BM_SizeHint(benchmark::State& state) {
+  size_t size = state.range(0);
+  auto& data = Dataset(size);
+  std::list<uint64_t> list(data.begin(), data.end());
+  auto map = ranges::Map([](auto&& num) { return num * 3; });
+  auto even = ranges::Filter([](auto&& num) { return num % 2 == 0; });
+  auto half = static_cast<std::ptrdiff_t>(size / 2);
+
+  for (auto _ : state) {
+    switch (state.range(1)) {
+      case SSListMap:
+        RunSizeQuery(state, View{list} | map);
+        break;
+      case SSFilterTake:
+        RunSizeQuery(state, View{data} | even | ranges::Take(half));
+        break;
+      case SSRepeatMap:
+        RunSizeQuery(state, View{data} | map | ranges::Repeat(4));
+        break;
+    }
+  }
+}
+
+enum AssociativeTarget {
+  ATMapInserter,
+  ATMap,
+  ATUnorderedInserter,
+  ATUnordered,
+  ATFlatMap,
+  ATHashMap
+};
+
+// Inserter is how Collect filled associative containers before bulk builds
+template <typename Container, typename Range>
+static Container InserterCollect(Range&& range) {
+  Container output;
+  auto inserter = std::inserter(output, output.end());
+  for (auto it = range.begin(), end = range.end(); it != end; ++it) {
+    *inserter = *it;
+  }
+  return output;
+}
+
+static void BM_AssociativeCollect(benchmark::State& state) {
+  size_t size = state.range(0);
+  auto& data = Dataset(size);
+  auto pairs = View{data} | ranges::Map([](auto&& num) {
+                 return std::pair<uint64_t, uint64_t>{num, num};
+               });
+  using Map = std::map<uint64_t, uint64_t>;
+  using Unordered = std::unordered_map<uint64_t, uint64_t>;
+
+  for (auto _ : state) {
+    switch (state.range(1)) {
+      case ATMapInserter:
+        benchmark::DoNotOptimize(InserterCollect<Map>(pairs));
+        break;
+      case ATMap:
+        benchmark::DoNotOptimize(pairs | ranges::Collect<Map>{});
+        break;
+      case ATUnorderedInserter:
+        benchmark::DoNotOptimize(InserterCollect<Unordered>(pairs));
+        break;
+      case ATUnordered:
+        benchmark::DoNotOptimize(pairs | ranges::Collect<Unordered>{});
+        break;
+      case ATFlatMap:
+        benchmark::DoNotOptimize(
+            pairs | ranges::Collect<FlatMap<uint64_t, uint64_t>>{});
+        break;
+      case ATHashMap:
+        benchmark::DoNotOptimize(
+            pairs | ranges::Collect<HashMap<uint64_t, uint64_t>>{});
+        break;
+    }
+  }
+}
+
+// Every key of the dataset looked up once, half of them present
+template <typename Container>
+static void RunAssociativeFind(benchmark::State& state,
+                               std::vector<uint64_t> const& data) {
+  auto present = View{data} | ranges::Take(data.size() / 2) |
+                 ranges::Map([](auto&& num) {
+                   return std::pair<uint64_t, uint64_t>{num, num};
+                 }) |
+                 ranges::Collect<Container>{};
+  for (auto _ : state) {
+    size_t found = 0;
+    for (auto&& num : data) {
+      found += Contains(present, num) ? 1 : 0;
+    }
+    benchmark::DoNotOptimize(found);
+  }
+}
+
+static void BM_AssociativeFind(benchmark::State& state) {
+  auto& data = Dataset(state.range(0));
+  switch (state.range(1)) {
+    case ATMap:
+      RunAssociativeFind<std::map<uint64_t, uint64_t>>(state, data);
+      break;
+    case ATUnordered:
+      RunAssociativeFind<std::unordered_map<uint64_t, uint64_t>>(state, data);
+      break;
+    case ATFlatMap:
+      RunAssociativeFind<FlatMap<uint64_t, uint64_t>>(state, data);
+      break;
+    case ATHashMap:
+      RunAssociativeFind<HashMap<uint64_t, uint64_t>>(state, data);
+      break;
+  }
+}
+
+enum IndexLookup { ILLinear, ILBinarySearch, ILIndex };
+
+static constexpr size_t kIndexQueries = 1024;
+
+// Half of the queries are keys of the dataset, the rest are almost surely
+// absent
+static void BM_IndexLookup(benchmark::State& state) {
+  auto& data = Dataset(state.range(0));
+  std::vector<uint64_t> queries;
+  for (size_t i = 0; i < kIndexQueries; ++i) {
+    queries.push_back(i % 2 == 0 ? data[SplitMix(kSeed, i) % data.size()]
+                                 : SplitMix(kSeed + 1, i));
+  }
+  std::vector<uint64_t> sorted;
+  SearchIndex<uint64_t> index;
+  if (state.range(1) == ILBinarySearch) {
+    sorted = data;
+    std::sort(sorted.begin(), sorted.end());
+  } else if (state.range(1) == ILIndex) {
+    index = Index(data);
+  }
+
+  for (auto _ : state) {
+    size_t found = 0;
+    for (auto&& query : queries) {
+      switch (state.range(1)) {
+        case ILLinear:
+          found += Contains(data, query) ? 1 : 0;
+          break;
+        case ILBinarySearch:
+          found += std::binary_search(sorted.begin(), sorted.end(), query);
+          break;
+        case ILIndex:
+          found += Contains(index, query) ? 1 : 0;
+          break;
+      }
+    }
+    benchmark::DoNotOptimize(found);
+  }
+  state.SetItemsProcessed(state.iterations() * kIndexQueries);
+}
+
+enum WindowAggregate { WASum, WAMin };
+enum WindowMode { WMNaive, WMStream, WMBatched };
+
+static constexpr size_t kWindowInput = 10000000;
+
+// Folds every window again, O(n * w)
+template <typename Agg>
+static uint64_t NaiveWindow(std::vector<uint64_t> const& data, size_t width,
+                            Agg agg) {
+  using Slice = View<std::vector<uint64_t> const>;
+  uint64_t total = 0;
+  for (size_t i = 0; i + width <= data.size(); ++i) {
+    total += Fold(Slice{data.begin() + i + 1, data.begin() + i + width},
+                  data[i], agg);
+  }
+  return total;
+}
+
+// The aggregates are summed rather than collected, writing them out costs as
+// much as computing them. A Map in front hides the contiguous input, so
+// Stream runs on buffered elements and Batched straight on the vector.
+template <typename Agg>
+static void RunWindow(benchmark::State& state,
+                      std::vector<uint64_t> const& data, Agg agg) {
+  size_t width = state.range(0);
+  auto identity = ranges::Map([](auto&& num) { return num; });
+  auto total = [](auto&& windows) {
+    return Fold(windows, uint64_t{0}, std::plus<>{});
+  };
+
+  for (auto _ : state) {
+    switch (state.range(2)) {
+      case WMNaive:
+        benchmark::DoNotOptimize(NaiveWindow(data, width, agg));
+        break;
+      case WMStream:
+        benchmark::DoNotOptimize(
+            total(View{data} | identity | ranges::Window(width, agg)));
+        break;
+      case WMBatched:
+        benchmark::DoNotOptimize(
+            total(View{data} | ranges::Window(width, agg)));
+        break;
+    }
+  }
+  state.SetItemsProcessed(state.iterations() * data.size());
+}
+
+static void BM_Window(benchmark::State& state) {
+  auto& data = Dataset(kWindowInput);
+  switch (state.range(1)) {
+    case WASum:
+      RunWindow(state, data, ranges::window::Sum{});
+      break;
+    case WAMin:
+      RunWindow(state, data, ranges::window::Min{});
+      break;
+  }
+}
+
+enum ScanMode { SCLoop, SCStd, SCView, SCParallel };
+
+static void BM_Scan(benchmark::State& state) {
+  static ThreadPool pool;
+  size_t size = state.range(0);
+  auto& data = Dataset(size);
+
+  for (auto _ : state) {
+    switch (state.range(1)) {
+      case SCLoop: {
+        std::vector<uint64_t> output(size);
+        uint64_t sum = 0;
+        for (size_t i = 0; i < size; ++i) {
+          output[i] = sum += data[i];
+        }
+        benchmark::DoNotOptimize(output);
+        break;
+      }
+      case SCStd: {
+        std::vector<uint64_t> output(size);
+        std::inclusive_scan(data.begin(), data.end(), output.begin());
+        benchmark::DoNotOptimize(output);
+        break;
+      }
+      case SCView:
+        benchmark::DoNotOptimize(View{data}  //
+                                 | ranges::Scan(std::plus<>{}, uint64_t{0})
+                                 | ranges::Collect<>{});
+        break;
+      case SCParallel:
+        benchmark::DoNotOptimize(
+            Scan(ranges::Parallel{pool}, data, std::plus<>{}, uint64_t{0}));
+        break;
+    }
+  }
+  state.SetItemsProcessed(state.iterations() * size);
+}
+
+enum VariantMix { VXUniform, VXSkewed, VXRuns };
+enum VariantMode {
+  VMVisit,
+  VMBatches,
+  VMBuildBatches,
+  VMVisitMap,
+  VMMapBatches
+};
+
+template <size_t I>
+struct Tagged {
+  static constexpr uint64_t kTag = I;
+  uint64_t value;
+};
+
+template <size_t... I>
+static std::variant<Tagged<I>...> TaggedVariant(std::index_sequence<I...>);
+
+template <size_t N>
+using TaggedEvent = decltype(TaggedVariant(std::make_index_sequence<N>{}));
+
+// Uniform over the alternatives, almost all of the first one, or runs of 1024
+// of the same one
+template <size_t N>
+static std::vector<TaggedEvent<N>> TaggedEvents(
+    std::vector<uint64_t> const& data, VariantMix mix) {
+  std::vector<TaggedEvent<N>> events;
+  events.reserve(data.size());
+  for (size_t i = 0; i < data.size(); ++i) {
+    size_t alternative = mix == VXUniform ? data[i] % N
+                         : mix == VXSkewed
+                             ? (data[i] % 16 == 0 ? data[i] / 16 % N : 0)
+                             : i / 1024 % N;
+    [&]<size_t... I>(std::index_sequence<I...>) {
+      ((alternative == I
+            ? (events.emplace_back(Tagged<I>{data[i]}), void())
+            : void()),
+       ...);
+    }(std::make_index_sequence<N>{});
+  }
+  return events;
+}
+
+template <size_t N>
+static void RunVariant(benchmark::State& state) {
+  size_t size = state.range(0);
+  auto events = TaggedEvents<N>(Dataset(size),
+                                static_cast<VariantMix>(state.range(2)));
+  auto batches = Batches(events);
+  auto arm = [](auto const& event) {
+    return (event.value >> event.kTag) + event.kTag;
+  };
+
+  for (auto _ : state) {
+    uint64_t sum = 0;
+    auto add = [&](auto const& event) { sum += arm(event); };
+    switch (state.range(3)) {
+      case VMVisit:
+        for (auto&& event : events) {
+          std::visit(add, event);
+        }
+        break;
+      case VMBatches:
+        VisitBatches(batches, add);
+        break;
+      case VMBuildBatches: {
+        auto built = Batches(events);
+        VisitBatches(built, add);
+        break;
+      }
+      case VMVisitMap:
+        benchmark::DoNotOptimize(
+            View{events}  //
+            | ranges::Map([&](auto&& event) { return std::visit(arm, event); })
+            | ranges::Collect<>{});
+        break;
+      case VMMapBatches:
+        benchmark::DoNotOptimize(MapBatches(batches, arm));
+        break;
+    }
+    benchmark::DoNotOptimize(sum);
+  }
+  state.SetItemsProcessed(state.iterations() * size);
+}
+
+static void BM_Variant(benchmark::State& state) {
+  switch (state.range(1)) {
+    case 2:
+      RunVariant<2>(state);
+      break;
+    case 4:
+      RunVariant<4>(state);
+      break;
+    case 8:
+      RunVariant<8>(state);
+      break;
+  }
+}
+
+enum TeeMode { TMSeparate, TMTee };
+
+// The filtered rows, their sum and their count
+static void BM_Tee(benchmark::State& state) {
+  size_t size = state.range(0);
+  auto& data = Dataset(size);
+  auto even = ranges::Filter([](auto&& num) { return num % 2 == 0; });
+
+  for (auto _ : state) {
+    switch (state.range(1)) {
+      case TMSeparate:
+        benchmark::DoNotOptimize(View{data} | even | ranges::Collect<>{});
+        benchmark::DoNotOptimize(
+            Fold(View{data} | even, uint64_t{0}, std::plus<>{}));
+        benchmark::DoNotOptimize(Len(View{data} | even));
+        break;
+      case TMTee:
+        benchmark::DoNotOptimize(
+            View{data} | even |
+            ranges::Tee(ranges::Collect<>{},
+                        ranges::Fold(uint64_t{0}, std::plus<>{}),
+                        ranges::Len{}));
+        break;
+    }
+  }
+  state.SetBytesProcessed(state.iterations() * size * sizeof(uint64_t));
+}
+
+// Allocations
+
+// Allocator that counts its allocations, for the outputs of a benchmark. The
+// count is per thread, so benchmarks running side by side do not mix.
+
+static thread_local size_t allocations = 0;
+
+template <typename T>
+struct CountingAllocator {
+  using value_type = T;
+
+  T* allocate(size_t n) {
+    ++allocations;
+    return std::allocator<T>{}.allocate(n);
+  }
+
+  void deallocate(T* ptr, size_t n) noexcept {
+    std::allocator<T>{}.deallocate(ptr, n);
+  }
+
+  template <typename U>
+  bool operator==(CountingAllocator<U> const&) const {
+    return true;
+  }
+
+  CountingAllocator() = default;
+
+  template <typename U>
+  CountingAllocator(CountingAllocator<U> const&) {}  // NOLINT
+};
+
+using CountedString =
+    std::basic_string<char, std::char_traits<char>, CountingAllocator<char>>;
+
+enum SplitMode { SPStrings, SPCollect, SPFold };
+
+// Space separated hex words of 1 to 16 digits, eight to a line
+static std::string const& LogText(size_t size) {
+  static std::mutex mutex;
+  static std::map<size_t, std::string> texts;
+
+  std::lock_guard lock{mutex};
+  auto&& text = texts[size];
+  if (text.empty()) {
+    auto& data = Dataset(size);
+    for (size_t i = 0; i < size; ++i) {
+      char word[16];
+      auto end = std::to_chars(word, word + sizeof(word),
+                               data[i] >> (data[i] % 61), 16)
+                     .ptr;
+      text.append(word, end);
+      text.push_back(i % 8 == 7 ? '\n' : ' ');
+    }
+  }
+  return text;
+}
+
+// Lines of a log: copied into strings, collected as views, or only measured.
+// Allocations are counted for the output containers and strings.
+static void BM_Split(benchmark::State& state) {
+  auto& text = LogText(state.range(0));
+  size_t lines = (state.range(0) + 7) / 8;
+  size_t before = allocations;
+
+  for (auto _ : state) {
+    switch (state.range(1)) {
+      case SPStrings: {
+        std::vector<CountedString, CountingAllocator<CountedString>> output;
+        for (size_t at = 0; at < text.size();) {
+          size_t stop = std::min(text.find('\n', at), text.size());
+          output.emplace_back(text.data() + at, stop - at);
+          at = stop + 1;
+        }
+        benchmark::DoNotOptimize(output);
+        break;
+      }
+      case SPCollect: {
+        auto output =
+            Lines(text) |
+            ranges::Collect<std::vector<
+                std::string_view, CountingAllocator<std::string_view>>>{};
+        benchmark::DoNotOptimize(output);
+        break;
+      }
+      case SPFold:
+        benchmark::DoNotOptimize(
+            Fold(Lines(text) | ranges::Map([](auto&& line) {
+                   return line.size();
+                 }),
+                 size_t{0}, std::plus<>{}));
+        break;
+    }
+  }
+  size_t made = allocations - before;
+  state.SetItemsProcessed(state.iterations() * lines);
+  state.SetBytesProcessed(state.iterations() * text.size());
+  state.counters["allocations_per_line"] =
+      static_cast<double>(made) /
+      static_cast<double>(std::max<size_t>(state.iterations() * lines, 1));
+}
+
+enum CollectPages { CPVector, CPHugePages, CPParallel, CPParallelHugePages };
+
+// Minor faults of the whole process, all threads included
+static int64_t PageFaults() {
+#ifdef __linux__
+  rusage usage{};
+  getrusage(RUSAGE_SELF, &usage);
+  return usage.ru_minflt;
+#else
+  return 0;
+#endif
+}
+
+// Large Collect outputs on fresh pages: small pages faulted in on the first
+// write, huge pages faulted in at allocation, and both filled in parallel
+static void BM_CollectPages(benchmark::State& state) {
+  static ThreadPool pool;
+  auto& data = Dataset(state.range(0));
+  ranges::Parallel parallel{pool};
+  int64_t faults = PageFaults();
+
+  for (auto _ : state) {
+    switch (state.range(1)) {
+      case CPVector:
+        benchmark::DoNotOptimize(View{data} | ranges::Collect<>{});
+        break;
+      case CPHugePages:
+        benchmark::DoNotOptimize(View{data} |
+                                 ranges::Collect<HugePageVector<uint64_t>>{});
+        break;
+      case CPParallel:
+        benchmark::DoNotOptimize(
+            Collect<std::vector<uint64_t>>(parallel, View{data}));
+        break;
+      case CPParallelHugePages:
+        benchmark::DoNotOptimize(
+            Collect<HugePageVector<uint64_t>>(parallel, View{data}));
+        break;
+    }
+  }
+  state.SetBytesProcessed(state.iterations() * 2 * data.size() *
+                          sizeof(uint64_t));
+  state.counters["faults"] = benchmark::Counter(
+      static_cast<double>(PageFaults() - faults),
+      benchmark::Counter::kAvgIterations);
+}
+
+enum AnyMode { AVStatic, AVAny, AVFunction, AVStrings };
+
+// Words too long for the small string buffer, so filtering moves them
+static std::vector<std::string> AnyWords(std::vector<uint64_t> const& data) {
+  std::vector<std::string> words;
+  words.reserve(data.size());
+  for (auto num : data) {
+    words.push_back(std::to_string(num) + std::string(16, '#'));
+  }
+  return words;
+}
+
+// Two filters over words as AnyStages, checked against the compiled query
+static void AnyStrings(benchmark::State& state,
+                       std::vector<uint64_t> const& data) {
+  auto words = AnyWords(data);
+  auto even = [](std::string const& word) { return word[0] % 2 == 0; };
+  auto thirds = [](std::string const& word) { return word.size() % 3 != 0; };
+  std::vector<AnyStage<std::string>> stages{
+      AnyStage<std::string>{ranges::Filter(even)},
+      AnyStage<std::string>{ranges::Filter(thirds)}};
+
+  auto expected = View{words} | ranges::Filter(even) |
+                  ranges::Filter(thirds) | ranges::Collect<>{};
+  if ((Chain(AnyView<std::string>{words}, stages) | ranges::Collect<>{}) !=
+      expected) {
+    state.SkipWithError("AnyView strings differ from the compiled query");
+    return;
+  }
+  for (auto _ : state) {
+    benchmark::DoNotOptimize(Chain(AnyView<std::string>{words}, stages) |
+                             ranges::Collect<>{});
+  }
+  state.SetItemsProcessed(state.iterations() * data.size());
+}
+
+// The same three stage query compiled in, as AnyStages chained at runtime,
+// and as a runtime list of std::function called on every element. Strings
+// run two filters over words, whose elements are moved rather than copied.
+static void BM_AnyView(benchmark::State& state) {
+  auto& data = Dataset(state.range(0));
+  if (state.range(1) == AVStrings) {
+    AnyStrings(state, data);
+    return;
+  }
+  auto even = [](uint64_t num) { return num % 2 == 0; };
+  auto scale = [](uint64_t num) { return num * 3 + 1; };
+  auto fifths = [](uint64_t num) { return num % 5 != 0; };
+
+  std::vector<AnyStage<uint64_t>> stages{
+      AnyStage<uint64_t>{ranges::Filter(even)},
+      AnyStage<uint64_t>{ranges::Map(scale)},
+      AnyStage<uint64_t>{ranges::Filter(fifths)}};
+  // Each returns whether the element goes on
+  std::vector<std::function<bool(uint64_t&)>> functions{
+      [&](uint64_t& num) { return even(num); },
+      [&](uint64_t& num) { return (num = scale(num), true); },
+      [&](uint64_t& num) { return fifths(num); }};
+
+  for (auto _ : state) {
+    switch (state.range(1)) {
+      case AVStatic:
+        benchmark::DoNotOptimize(View{data}                  //
+                                 | ranges::Filter(even)      //
+                                 | ranges::Map(scale)        //
+                                 | ranges::Filter(fifths)    //
+                                 | ranges::Collect<>{});
+        break;
+      case AVAny:
+        benchmark::DoNotOptimize(Chain(AnyView<uint64_t>{data}, stages) |
+                                 ranges::Collect<>{});
+        break;
+      case AVFunction: {
+        std::vector<uint64_t> output;
+        for (auto num : data) {
+          bool kept = true;
+          for (auto&& function : functions) {
+            if (!function(num)) {
+              kept = false;
+              break;
+            }
+          }
+          if (kept) {
+            output.push_back(num);
+          }
+        }
+        benchmark::DoNotOptimize(output);
+        break;
+      }
+    }
+  }
+  state.SetItemsProcessed(state.iterations() * data.size());
+}
+
+enum PackedMode { PKPlain, PKPacked, PKEncode };
+
+// Datasets of the distribution in the second argument
+static void PackedSetup(const benchmark::State& state) {
+  KeepLargeDataset(DatasetKey{state.range(0),
+                              static_cast<Distribution>(state.range(1)),
+                              kSeed});
+}
+
+// bytes_per_element is the footprint of the scanned column
+static void BM_PackedFilterCollect(benchmark::State& state) {
+  size_t size = state.range(0);
+  auto& data = Dataset(size, static_cast<Distribution>(state.range(1)));
+  auto packed = Collect<PackedColumn<uint64_t>>(View{data});
+  auto even = [](auto&& num) { return num % 2 == 0; };
+
+  for (auto _ : state) {
+    switch (state.range(2)) {
+      case PKPlain:
+        benchmark::DoNotOptimize(View{data}             //
+                                 | ranges::Filter(even)  //
+                                 | ranges::Collect<>{});
+        break;
+      case PKPacked:
+        benchmark::DoNotOptimize(View{packed}           //
+                                 | ranges::Filter(even)  //
+                                 | ranges::Collect<>{});
+        break;
+      case PKEncode:
+        benchmark::DoNotOptimize(View{data}  //
+                                 | ranges::Collect<PackedColumn<uint64_t>>{});
+        break;
+    }
+  }
+  state.SetBytesProcessed(state.iterations() * size * sizeof(uint64_t));
+  state.counters["bytes_per_element"] =
+      state.range(2) == PKPlain
+          ? sizeof(uint64_t)
+          : static_cast<double>(packed.Bytes()) / std::max<size_t>(size, 1);
+}
+
+enum PrefetchMode { PMPlain, PMPrefetch };
+
+static constexpr size_t kPrefetchDistance = 16;
+
+// Sorting relinks the nodes, so the traversal order no longer follows the
+// allocation order. Prefetch passes linked sources through, both modes
+// should take the same time here and in BM_PrefetchMap.
+static void BM_PrefetchList(benchmark::State& state) {
+  size_t size = state.range(0);
+  auto& data = Dataset(size);
+  std::list<uint64_t> list(data.begin(), data.end());
+  list.sort();
+  auto even = ranges::Filter([](auto&& num) { return num % 2 == 0; });
+
+  for (auto _ : state) {
+    switch (state.range(1)) {
+      case PMPlain:
+        benchmark::DoNotOptimize(
+            Fold(View{list} | even, uint64_t{0}, std::plus<>{}));
+        break;
+      case PMPrefetch:
+        benchmark::DoNotOptimize(
+            Fold(View{list} | ranges::Prefetch(kPrefetchDistance) | even,
+                 uint64_t{0}, std::plus<>{}));
+        break;
+    }
+  }
+}
+
+static void BM_PrefetchMap(benchmark::State& state) {
+  size_t size = state.range(0);
+  std::map<uint64_t, uint64_t> map;
+  for (auto&& num : Dataset(size)) {
+    map.emplace(num, num);
+  }
+  auto even = ranges::Filter([](auto&& num) { return num % 2 == 0; });
+
+  for (auto _ : state) {
+    switch (state.range(1)) {
+      case PMPlain:
+        benchmark::DoNotOptimize(Fold(View{map} | ranges::Map(Second{}) | even,
+                                      uint64_t{0}, std::plus<>{}));
+        break;
+      case PMPrefetch:
+        benchmark::DoNotOptimize(
+            Fold(View{map} | ranges::Prefetch(kPrefetchDistance)  //
+                     | ranges::Map(Second{}) | even,
+                 uint64_t{0}, std::plus<>{}));
+        break;
+    }
+  }
+}
+
+struct HeapObject {
+  uint64_t value;
+  uint64_t padding[7];
+};
+
+static void BM_PrefetchPointers(benchmark::State& state) {
+  size_t size = state.range(0);
+  auto& data = Dataset(size);
+  std::vector<std::unique_ptr<HeapObject>> objects;
+  objects.reserve(size);
+  for (auto&& num : data) {
+    objects.push_back(std::make_unique<HeapObject>(HeapObject{num, {}}));
+  }
+  std::vector<HeapObject*> pointers;
+  for (auto&& object : objects) {
+    pointers.push_back(object.get());
+  }
+  std::shuffle(pointers.begin(), pointers.end(), std::mt19937{42});
+  auto value = ranges::Map([](HeapObject* object) { return object->value; });
+  auto pointee = [](HeapObject* object) { return object; };
+
+  for (auto _ : state) {
+    switch (state.range(1)) {
+      case PMPlain:
+        benchmark::DoNotOptimize(
+            Fold(View{pointers} | value, uint64_t{0}, std::plus<>{}));
+        break;
+      case PMPrefetch:
+        benchmark::DoNotOptimize(
+            Fold(View{pointers}                                      //
+                     | ranges::Prefetch(kPrefetchDistance, pointee)  //
+                     | value,
+                 uint64_t{0}, std::plus<>{}));
+        break;
+    }
+  }
+}
+
+// Scaling: every thread runs its own pipeline over its own slice of the data.
+// Bytes count both the elements read and the elements written, like STREAM.
+
+// Threads of the widest run, every thread count slices the same dataset
+static size_t ScalingThreads() {
+  return std::max(1U, std::thread::hardware_concurrency());
+}
+
+static std::span<uint64_t const> ScalingSlice(benchmark::State& state) {
+  size_t size = state.range(0);
+  return std::span{Dataset(size * ScalingThreads())}.subspan(
+      state.thread_index() * size, size);
+}
+
+// The scaling datasets are the largest ones. Each is kept for every family
+// and thread count and freed after the last run over it: the pinned run with
+// the most threads, in the family registered last.
+static void ScalingTeardown(const benchmark::State& state) {
+  if (state.range(1) != 0 &&
+      static_cast<size_t>(state.threads()) == ScalingThreads()) {
+    ReleaseDataset(state.range(0) * ScalingThreads());
+  }
+}
+
+// Second argument selects pinning thread i to core i. The previous mask is
+// restored when the pin goes out of scope: the main thread runs thread 0,
+// and threads started later inherit its mask.
+class ThreadPin {
+ public:
+  explicit ThreadPin(benchmark::State& state) {
+#ifdef __linux__
+    if (state.range(1) != 0) {
+      _pinned = pthread_getaffinity_np(pthread_self(), sizeof(_saved),
+                                       &_saved) == 0;
+      cpu_set_t set;
+      CPU_ZERO(&set);
+      CPU_SET(state.thread_index() % std::thread::hardware_concurrency(),
+              &set);
+      pthread_setaffinity_np(pthread_self(), sizeof(set), &set);
+    }
+#endif
+  }
+
+  ~ThreadPin() {
+#ifdef __linux__
+    if (_pinned) {
+      pthread_setaffinity_np(pthread_self(), sizeof(_saved), &_saved);
+    }
+#endif
+  }
+
+  ThreadPin(ThreadPin const&) = delete;
+  ThreadPin& operator=(ThreadPin const&) = delete;
+
+ private:
+#ifdef __linux__
+  cpu_set_t _saved;
+  bool _pinned = false;
+#endif
+};
+
+template <typename Pipeline>
+static void RunScaling(benchmark::State& state, Pipeline pipeline) {
+  auto slice = ScalingSlice(state);
+  ThreadPin pin{state};
+  int64_t bytes = 0;
+  for (auto _ : state) {
+    auto output = pipeline(slice);
+    bytes += (slice.size() + output.size()) * sizeof(uint64_t);
+    benchmark::DoNotOptimize(output);
+  }
+  state.SetBytesProcessed(bytes);
+}
+
+static void BM_ScalingStreamCopy(benchmark::State& state) {
+  auto slice = ScalingSlice(state);
+  std::vector<uint64_t> output(slice.size());
+  ThreadPin pin{state};
+  for (auto _ : state) {
+    std::copy(slice.begin(), slice.end(), output.begin());
+    benchmark::ClobberMemory();
+  }
+  state.SetBytesProcessed(state.iterations() * 2 * slice.size() *
+                          sizeof(uint64_t));
+}
+
+static void BM_ScalingFilterCollect(benchmark::State& state) {
+  RunScaling(state, [](auto&& slice) {
+    return View{slice}                                                //
+           | ranges::Filter([](auto&& num) { return num % 2 == 0; })  //
+           | ranges::Collect<>{};
+  });
+}
+
+static void BM_ScalingFilterMapCollect(benchmark::State& state) {
+  RunScaling(state, [](auto&& slice) {
+    return View{slice}                                                //
+           | ranges::Filter([](auto&& num) { return num % 2 == 0; })  //
+           | ranges::Map([](auto&& num) { return num * num; })        //
+           | ranges::Collect<>{};
+  });
+}
+
+static void BM_ScalingMapFilterCollect(benchmark::State& state) {
+  RunScaling(state, [](auto&& slice) {
+    return View{slice}                                                //
+           | ranges::Map([](auto&& num) { return num * num; })        //
+           | ranges::Filter([](auto&& num) { return num % 2 == 0; })  //
+           | ranges::Collect<>{};
+  });
+}
+
+static void ScalingArgs(benchmark::internal::Benchmark* bench) {
+  bench->ArgsProduct({{1000000, 10000000}, {0, 1}})
+      ->ThreadRange(1, static_cast<int>(ScalingThreads()))
+      ->UseRealTime();
+}
+
 BENCHMARK(BM_FilterCollect)
     ->Args({100, FCStl})
     ->Args({100, FCStorm})   //
@@ -154,7 +1591,7 @@ BENCHMARK(BM_FilterCollect)
     ->Args({100000000, FCStl})
     ->Args({100000000, FCStorm})   //
     ->Args({100000000, FCSimple})  //
-    ;
+    ->Setup(LargeDatasetSetup);
 
 BENCHMARK(BM_FilterMapCollect)
     ->Args({100, FMCStl})
@@ -175,7 +1612,7 @@ BENCHMARK(BM_FilterMapCollect)
     ->Args({100000000, FMCStl})
     ->Args({100000000, FMCStormOptimized})
     ->Args({100000000, FMCStorm})  //
-    ;
+    ->Setup(LargeDatasetSetup);
 
 BENCHMARK(BM_MapFilterCollect)
     ->Args({100, FMCStl})
@@ -196,5 +1633,194 @@ BENCHMARK(BM_MapFilterCollect)
     ->Args({100000000, FMCStl})
     ->Args({100000000, FMCStormOptimized})
     ->Args({100000000, FMCStorm})  //
+    ->Setup(LargeDatasetSetup);
+
+BENCHMARK(BM_DeepPipelineCollect)
+    ->Args({100, DPStl})
+    ->Args({100, DPStorm})  //
+    ->Args({1000, DPStl})
+    ->Args({1000, DPStorm})  //
+    ->Args({10000, DPStl})
+    ->Args({10000, DPStorm})  //
+    ->Args({100000, DPStl})
+    ->Args({100000, DPStorm})  //
+    ->Args({1000000, DPStl})
+    ->Args({1000000, DPStorm})  //
+    ->Args({100000000, DPStl})
+    ->Args({100000000, DPStorm})  //
+    ->Setup(LargeDatasetSetup);
+
+BENCHMARK(BM_LargeCaptureFilterMapCollect)
+    ->Args({100, LCStl})
+    ->Args({100, LCStorm})   //
+    ->Args({100, LCSimple})  //
+    ->Args({1000, LCStl})
+    ->Args({1000, LCStorm})   //
+    ->Args({1000, LCSimple})  //
+    ->Args({10000, LCStl})
+    ->Args({10000, LCStorm})   //
+    ->Args({10000, LCSimple})  //
+    ->Args({1000000, LCStl})
+    ->Args({1000000, LCStorm})   //
+    ->Args({1000000, LCSimple})  //
     ;
+
+BENCHMARK(BM_CacheRepeat)
+    ->Args({1000, CMPlain})
+    ->Args({1000, CMCache})
+    ->Args({1000, CMBlockCache})  //
+    ->Args({100000, CMPlain})
+    ->Args({100000, CMCache})
+    ->Args({100000, CMBlockCache})  //
+    ->Args({10000000, CMPlain})
+    ->Args({10000000, CMCache})
+    ->Args({10000000, CMBlockCache})  //
+    ->Setup(LargeDatasetSetup);
+
+BENCHMARK(BM_CacheMultiPass)
+    ->Args({1000, CMPlain})
+    ->Args({1000, CMCache})
+    ->Args({1000, CMBlockCache})  //
+    ->Args({100000, CMPlain})
+    ->Args({100000, CMCache})
+    ->Args({100000, CMBlockCache})  //
+    ->Args({10000000, CMPlain})
+    ->Args({10000000, CMCache})
+    ->Args({10000000, CMBlockCache})  //
+    ->Setup(LargeDatasetSetup);
+
+BENCHMARK(BM_SnapshotReaders)
+    ->Setup(SnapshotSetup)
+    ->Teardown(SnapshotTeardown)
+    ->Args({1000, SMEpoch})
+    ->Args({1000, SMSharedMutex})  //
+    ->Args({1000000, SMEpoch})
+    ->Args({1000000, SMSharedMutex})  //
+    ->Threads(2)
+    ->Threads(4)
+    ->Threads(8)
+    ->UseRealTime();
+
+BENCHMARK(BM_GeneratorFilterCollect)
+    ->Args({1000, GSVector})
+    ->Args({1000, GSElement})
+    ->Args({1000, GSBatch})
+    ->Args({1000, GSAsync})  //
+    ->Args({1000000, GSVector})
+    ->Args({1000000, GSElement})
+    ->Args({1000000, GSBatch})
+    ->Args({1000000, GSAsync})  //
+    ->Args({100000000, GSVector})
+    ->Args({100000000, GSElement})
+    ->Args({100000000, GSBatch})
+    ->Args({100000000, GSAsync})  //
+    ->UseRealTime()
+    ->Setup(LargeDatasetSetup);
+
+BENCHMARK(BM_BitmapFilterCollect)
+    ->Args({1000, BQFilter})
+    ->Args({1000, BQCold})
+    ->Args({1000, BQWarm})  //
+    ->Args({100000, BQFilter})
+    ->Args({100000, BQCold})
+    ->Args({100000, BQWarm})  //
+    ->Args({10000000, BQFilter})
+    ->Args({10000000, BQCold})
+    ->Args({10000000, BQWarm})  //
+    ->Setup(LargeDatasetSetup);
+
+BENCHMARK(BM_PrefetchList)
+    ->Args({1000, PMPlain})
+    ->Args({1000, PMPrefetch})  //
+    ->Args({100000, PMPlain})
+    ->Args({100000, PMPrefetch})  //
+    ->Args({10000000, PMPlain})
+    ->Args({10000000, PMPrefetch})  //
+    ->Setup(LargeDatasetSetup);
+
+BENCHMARK(BM_PrefetchMap)
+    ->Args({1000, PMPlain})
+    ->Args({1000, PMPrefetch})  //
+    ->Args({100000, PMPlain})
+    ->Args({100000, PMPrefetch})  //
+    ->Args({10000000, PMPlain})
+    ->Args({10000000, PMPrefetch})  //
+    ->Setup(LargeDatasetSetup);
+
+BENCHMARK(BM_PrefetchPointers)
+    ->Args({1000, PMPlain})
+    ->Args({1000, PMPrefetch})  //
+    ->Args({100000, PMPlain})
+    ->Args({100000, PMPrefetch})  //
+    ->Args({10000000, PMPlain})
+    ->Args({10000000, PMPrefetch})  //
+    ->Setup(LargeDatasetSetup);
+
+BENCHMARK(BM_ScalingStreamCopy)->Apply(ScalingArgs);
+BENCHMARK(BM_ScalingFilterCollect)->Apply(ScalingArgs);
+BENCHMARK(BM_ScalingFilterMapCollect)->Apply(ScalingArgs);
+BENCHMARK(BM_ScalingMapFilterCollect)
+    ->Apply(ScalingArgs)
+    ->Teardown(ScalingTeardown);
+BENCHMARK(BM_Extrema)
+    ->ArgsProduct({{1000, 1000000},
+                   {ESView, ESMapView},
+                   {EXNaive, EXMax, EXMinMax, EXArgMax, EXParallelMax}});
+BENCHMARK(BM_SizeHint)
+    ->ArgsProduct({{1000, 1000000},
+                   {SSListMap, SSFilterTake, SSRepeatMap},
+                   {SQWalk, SQLen, SQCollect}});
+BENCHMARK(BM_AssociativeCollect)
+    ->ArgsProduct({{1000, 1000000},
+                   {ATMapInserter, ATMap, ATUnorderedInserter, ATUnordered,
+                    ATFlatMap, ATHashMap}});
+BENCHMARK(BM_AssociativeFind)
+    ->ArgsProduct(
+        {{1000, 1000000}, {ATMap, ATUnordered, ATFlatMap, ATHashMap}});
+BENCHMARK(BM_IndexLookup)
+    ->ArgsProduct({{1000, 100000, 1000000}, {ILLinear}})
+    ->ArgsProduct({{1000, 100000, 1000000, 10000000, 100000000},
+                   {ILBinarySearch, ILIndex}})
+    ->Setup(LargeDatasetSetup);
+BENCHMARK(BM_Window)
+    ->ArgsProduct({{8, 64}, {WASum, WAMin}, {WMNaive}})
+    ->ArgsProduct({{8, 64, 1024, 100000, 1000000},
+                   {WASum, WAMin},
+                   {WMStream, WMBatched}});
+BENCHMARK(BM_Scan)
+    ->ArgsProduct(
+        {{1000, 1000000, 100000000}, {SCLoop, SCStd, SCView, SCParallel}})
+    ->Setup(LargeDatasetSetup);
+BENCHMARK(BM_Variant)
+    ->ArgsProduct({{1000000},
+                   {2, 4, 8},
+                   {VXUniform, VXSkewed, VXRuns},
+                   {VMVisit, VMBatches, VMBuildBatches, VMVisitMap,
+                    VMMapBatches}});
+BENCHMARK(BM_Tee)
+    ->ArgsProduct({{1000000, 100000000}, {TMSeparate, TMTee}})
+    ->Setup(LargeDatasetSetup);
+BENCHMARK(BM_Split)
+    ->ArgsProduct({{1000000, 10000000}, {SPStrings, SPCollect, SPFold}})
+    ->Setup(LargeDatasetSetup);
+BENCHMARK(BM_CollectPages)
+    ->ArgsProduct({{1000000, 100000000},
+                   {CPVector, CPHugePages, CPParallel, CPParallelHugePages}})
+    ->Setup(LargeDatasetSetup)
+    ->UseRealTime();
+BENCHMARK(BM_AnyView)
+    ->ArgsProduct({{1000000, 10000000}, {AVStatic, AVAny, AVFunction}})
+    ->Setup(LargeDatasetSetup);
+BENCHMARK(BM_AnyView)->Args({1000000, AVStrings});
+BENCHMARK(BM_Compare)
+    ->ArgsProduct({{1000, 1000000},
+                   {CSView, CSFilter},
+                   {CPNaive, CPEqual, CPMismatch, CPLexCompare}});
+
+BENCHMARK(BM_PackedFilterCollect)
+    ->ArgsProduct({{1000, 1000000, 100000000},
+                   {DSSmallRange, DSSorted},
+                   {PKPlain, PKPacked, PKEncode}})
+    ->Setup(PackedSetup);
+
 BENCHMARK_MAIN();
@@ -0,0 +1,143 @@
+// C++20 module interface over ranges.h, built when RANGES_MODULE is on.
+// Importers get the same names as includers, `import ranges;`.
+
+module;
+
+#include "ranges.h"
+
+export module ranges;
+
+export {
+  using ::AnyStage;
+  using ::AnyView;
+  using ::ArgMax;
+  using ::ArgMin;
+  using ::AsyncGenerator;
+  using ::Batches;
+  using ::Bitmap;
+  using ::BitmapCache;
+  using ::BitmapView;
+  using ::BorrowsView;
+  using ::Cache;
+  using ::CacheView;
+  using ::Chain;
+  using ::Collect;
+  using ::Contains;
+  using ::Count;
+  using ::Difference;
+  using ::Distance;
+  using ::Equal;
+  using ::ExclusiveScan;
+  using ::Filter;
+  using ::FilterBy;
+  using ::FilterMap;
+  using ::FilterMapView;
+  using ::FilterView;
+  using ::Find;
+  using ::FindFirst;
+  using ::FindIf;
+  using ::FlatMap;
+  using ::FlatSet;
+  using ::FlatTable;
+  using ::First;
+  using ::Flatten;
+  using ::FlattenView;
+  using ::Fold;
+  using ::ForEach;
+  using ::FunctorRef;
+  using ::FunctorStorage;
+  using ::FunctorWrapper;
+  using ::Generator;
+  using ::GetIter;
+  using ::GetIterReference;
+  using ::GetSentinel;
+  using ::GetSizeHint;
+  using ::GetValueType;
+  using ::HashMap;
+  using ::HugePageAllocator;
+  using ::HugePageVector;
+  using ::Index;
+  using ::IsInlineFunctor;
+  using ::IsRandomAccess;
+  using ::IsRange;
+  using ::IsSized;
+  using ::IsStateless;
+  using ::IsView;
+  using ::LazyLen;
+  using ::Len;
+  using ::LexCompare;
+  using ::Lines;
+  using ::Map;
+  using ::MapBatches;
+  using ::MapView;
+  using ::Max;
+  using ::Min;
+  using ::MinMax;
+  using ::Mismatch;
+  using ::Overloaded;
+  using ::OwningView;
+  using ::PackedColumn;
+  using ::Prefetch;
+  using ::PrefetchView;
+  using ::RefCountView;
+  using ::Repeat;
+  using ::RepeatView;
+  using ::Scan;
+  using ::ScanView;
+  using ::SearchIndex;
+  using ::Second;
+  using ::SizeHint;
+  using ::Sized;
+  using ::SizedView;
+  using ::SnapshotSource;
+  using ::SnapshotView;
+  using ::Split;
+  using ::SplitView;
+  using ::SyncWait;
+  using ::Take;
+  using ::TakeView;
+  using ::Task;
+  using ::Tee;
+  using ::ThreadPool;
+  using ::VariantBatches;
+  using ::View;
+  using ::VisitBatches;
+  using ::Window;
+  using ::WindowView;
+  using ::operator|;
+}
+
+export namespace ranges {
+using ranges::Batches;
+using ranges::Branch;
+using ranges::Cache;
+using ranges::Collect;
+using ranges::CollectAsync;
+using ranges::ExclusiveScan;
+using ranges::Filter;
+using ranges::FilterBy;
+using ranges::FilterMap;
+using ranges::Flatten;
+using ranges::Fold;
+using ranges::ForEach;
+using ranges::ForEachAsync;
+using ranges::Index;
+using ranges::Len;
+using ranges::Map;
+using ranges::Max;
+using ranges::Min;
+using ranges::Parallel;
+using ranges::Prefetch;
+using ranges::Repeat;
+using ranges::Scan;
+using ranges::Take;
+using ranges::Tee;
+using ranges::Window;
+}  // namespace ranges
+
+export namespace ranges::window {
+using ranges::window::Count;
+using ranges::window::Max;
+using ranges::window::Min;
+using ranges::window::Sum;
+}  // namespace ranges::window
@@ -0,0 +1,316 @@
+#pragma once
+#include <algorithm>
+#include <cstddef>
+#include <iterator>
+#include <memory>
+#include <span>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+#include "core.h"
+#include "filter.h"
+#include "map.h"
+
+// AnyView, AnyStage
+
+// Type-erased pipelines of T for queries put together at runtime. The
+// virtual interface moves blocks: a source fills a span of up to kBatch
+// elements per call and every AnyStage rewrites the block in place, so
+// dispatch costs one call per block and stage instead of one per element.
+// AnyStage erases a Map (T to T) or a Filter, Chain applies a runtime list
+// of them. AnyView is single pass and copies share the position, like
+// Generator.
+
+namespace ranges::detail {
+template <typename T>
+struct AnySource {
+  virtual ~AnySource() = default;
+
+  // Fills a prefix of out and returns its length, zero only at the end
+  virtual size_t NextBatch(std::span<T> out) = 0;
+
+  virtual SizeHint Hint() const = 0;
+};
+
+template <typename T>
+struct AnyKernel {
+  virtual ~AnyKernel() = default;
+
+  // Rewrites batch in place, returns how many elements are left in front
+  virtual size_t Apply(std::span<T> batch) = 0;
+
+  virtual SizeHint Hint(SizeHint upstream) const = 0;
+};
+
+// Views are held by value like any upstream, containers by reference when
+// they are lvalues and moved in otherwise
+template <typename Range>
+using AnyStored = std::conditional_t<!IsView<Range>::value &&
+                                         std::is_lvalue_reference_v<Range>,
+                                     View<std::remove_reference_t<Range>>,
+                                     std::decay_t<Range>>;
+
+template <typename T, typename Range>
+class RangeSource : public AnySource<T> {
+ public:
+  template <typename R>
+  explicit RangeSource(R &&range)
+      : _range(std::forward<R>(range)),
+        _it(std::begin(_range)),
+        _end(std::end(_range)),
+        _left(GetSizeHint(_range)) {}
+
+  size_t NextBatch(std::span<T> out) override {
+    size_t count = 0;
+    for (; count < out.size() && _it != _end; ++_it, ++count) {
+      out[count] = *_it;
+    }
+    _left = {_left.lower - std::min(_left.lower, count),
+             _left.upper.has_value()
+                 ? std::optional{*_left.upper - std::min(*_left.upper, count)}
+                 : std::nullopt};
+    return count;
+  }
+
+  SizeHint Hint() const override { return _left; }
+
+ private:
+  Range _range;
+  GetIter<Range> _it;
+  GetSentinel<Range> _end;
+  SizeHint _left;
+};
+
+template <typename T, typename Func>
+class MapKernel : public AnyKernel<T> {
+ public:
+  explicit MapKernel(FunctorWrapper<Func> func) : _func(std::move(func)) {}
+
+  size_t Apply(std::span<T> batch) override {
+    for (auto &&element : batch) {
+      element = static_cast<T>(_func(element));
+    }
+    return batch.size();
+  }
+
+  SizeHint Hint(SizeHint upstream) const override { return upstream; }
+
+ private:
+  FunctorWrapper<Func> _func;
+};
+
+template <typename T, typename Pred>
+class FilterKernel : public AnyKernel<T> {
+ public:
+  explicit FilterKernel(FunctorWrapper<Pred> pred) : _pred(std::move(pred)) {}
+
+  // Trivial elements are written unconditionally and kept by advancing the
+  // cursor, so the compaction does not branch on the predicate. Others are
+  // only moved past a dropped element, moving one onto itself may empty it.
+  size_t Apply(std::span<T> batch) override {
+    size_t kept = 0;
+    for (auto &&element : batch) {
+      if constexpr (std::is_trivially_copyable_v<T>) {
+        T value = element;
+        batch[kept] = value;
+        kept += static_cast<size_t>(static_cast<bool>(_pred(value)));
+      } else if (_pred(element)) {
+        if (&batch[kept] != &element) {
+          batch[kept] = std::move(element);
+        }
+        ++kept;
+      }
+    }
+    return kept;
+  }
+
+  SizeHint Hint(SizeHint upstream) const override { return upstream.Subset(); }
+
+ private:
+  FunctorWrapper<Pred> _pred;
+};
+}  // namespace ranges::detail
+
+template <typename T>
+class AnyView {
+ public:
+  static constexpr size_t kBatch = 256;
+
+ private:
+  struct State {
+    // Refills the buffer once it is consumed, empty at the end
+    void Pull() {
+      if (index == count) {
+        count = source->NextBatch(buffer);
+        index = 0;
+      }
+    }
+
+    // The unread part of the buffer first, then blocks of the source
+    size_t NextBatch(std::span<T> out) {
+      if (index < count) {
+        auto n = std::min(out.size(), count - index);
+        std::move(buffer.begin() + index, buffer.begin() + index + n,
+                  out.begin());
+        index += n;
+        return n;
+      }
+      return source->NextBatch(out);
+    }
+
+    SizeHint Hint() const {
+      auto buffered = count - index;
+      auto hint = source->Hint();
+      return {hint.lower + buffered,
+              hint.upper.has_value() ? std::optional{*hint.upper + buffered}
+                                     : std::nullopt};
+    }
+
+    std::unique_ptr<ranges::detail::AnySource<T>> source;
+    std::vector<T> buffer = std::vector<T>(kBatch);
+    size_t index = 0;
+    size_t count = 0;
+  };
+
+  struct AnySentinel {};
+
+  struct AnyIterator {
+    using iterator_category = std::input_iterator_tag;
+    using value_type = T;
+    using difference_type = std::ptrdiff_t;
+    using reference = T const &;
+    using pointer = T const *;
+
+    reference operator*() const { return state->buffer[state->index]; }
+
+    AnyIterator &operator++() {
+      ++state->index;
+      state->Pull();
+      return *this;
+    }
+
+    void operator++(int)  // NOLINT
+    {
+      ++*this;
+    }
+
+    bool operator==(const AnySentinel &) const { return state->count == 0; }
+    bool operator!=(const AnySentinel &) const { return state->count != 0; }
+
+    State *state;
+  };
+
+  // Blocks of the upstream rewritten by a stage, empty blocks are skipped
+  class StageSource : public ranges::detail::AnySource<T> {
+   public:
+    StageSource(AnyView upstream,
+                std::shared_ptr<ranges::detail::AnyKernel<T>> kernel)
+        : _upstream(std::move(upstream._state)), _kernel(std::move(kernel)) {}
+
+    size_t NextBatch(std::span<T> out) override {
+      while (size_t count = _upstream->NextBatch(out)) {
+        if (size_t kept = _kernel->Apply(out.first(count))) {
+          return kept;
+        }
+      }
+      return 0;
+    }
+
+    SizeHint Hint() const override {
+      return _kernel->Hint(_upstream->Hint());
+    }
+
+   private:
+    std::shared_ptr<State> _upstream;
+    std::shared_ptr<ranges::detail::AnyKernel<T>> _kernel;
+  };
+
+  template <typename>
+  friend class AnyStage;
+
+ public:
+  using Source = std::unique_ptr<ranges::detail::AnySource<T>>;
+
+  using value_type = T;
+  using iterator = AnyIterator;
+  using sentinel = AnySentinel;
+
+  iterator begin()  // NOLINT
+  {
+    _state->Pull();
+    return {_state.get()};
+  }
+
+  sentinel end()  // NOLINT
+  {
+    return {};
+  }
+
+  SizeHint Hint() const { return _state->Hint(); }
+
+  // Up to out.size() of the next elements, zero only at the end
+  size_t NextBatch(std::span<T> out) { return _state->NextBatch(out); }
+
+  template <typename Range>
+    requires(!std::is_same_v<std::decay_t<Range>, AnyView> &&
+             !std::is_convertible_v<Range, Source>)
+  explicit AnyView(Range &&range)
+      : AnyView(std::make_unique<ranges::detail::RangeSource<
+                    T, ranges::detail::AnyStored<Range &&>>>(
+            std::forward<Range>(range))) {}
+
+  explicit AnyView(Source source)
+      : _state(std::make_shared<State>()) {
+    _state->source = std::move(source);
+  }
+
+ private:
+  std::shared_ptr<State> _state;
+};
+
+template <typename T>
+struct IsView<AnyView<T>> : std::true_type {};
+
+// Stage of a runtime pipeline over T. Copies share the functor.
+template <typename T>
+class AnyStage {
+ public:
+  template <typename Range>  //
+  AnyView<T> operator()(Range &&range) const {
+    if constexpr (std::is_same_v<std::decay_t<Range>, AnyView<T>>) {
+      return AnyView<T>{std::make_unique<typename AnyView<T>::StageSource>(
+          range, _kernel)};
+    } else {
+      return (*this)(AnyView<T>{std::forward<Range>(range)});
+    }
+  }
+
+  template <typename Func>
+  explicit AnyStage(ranges::Map<Func> map)
+      : _kernel(std::make_shared<ranges::detail::MapKernel<T, Func>>(
+            map.Functor())) {}
+
+  template <typename Pred>
+  explicit AnyStage(ranges::Filter<Pred> filter)
+      : _kernel(std::make_shared<ranges::detail::FilterKernel<T, Pred>>(
+            filter.Functor())) {}
+
+ private:
+  std::shared_ptr<ranges::detail::AnyKernel<T>> _kernel;
+};
+
+template <typename T>  //
+inline AnyView<T> Chain(AnyView<T> view,
+                        std::span<AnyStage<T> const> stages) {
+  for (auto &&stage : stages) {
+    view = stage(std::move(view));
+  }
+  return view;
+}
+
+template <typename T>  //
+inline AnyView<T> Chain(AnyView<T> view,
+                        std::vector<AnyStage<T>> const &stages) {
+  return Chain(std::move(view), std::span<AnyStage<T> const>{stages});
+}
@@ -0,0 +1,158 @@
+#pragma once
+#include <atomic>
+#include <coroutine>
+#include <functional>
+#include <optional>
+#include <utility>
+#include <vector>
+
+#include "core.h"
+#include "task.h"
+#include "thread_pool.h"
+
+// AsyncGenerator
+
+// Coroutine source whose body may co_await, e.g. I/O or a hop to a
+// ThreadPool. It yields owned batches, so a consumer can process one batch
+// while Prefetch already runs the producer for the next one.
+
+template <typename T>
+class AsyncGenerator {
+ public:
+  struct promise_type {
+    AsyncGenerator get_return_object() {
+      return AsyncGenerator{
+          std::coroutine_handle<promise_type>::from_promise(*this)};
+    }
+
+    // Whichever of producer and consumer arrives second resumes the consumer
+    struct HandoffAwaiter {
+      bool await_ready() const noexcept { return false; }
+      std::coroutine_handle<> await_suspend(
+          std::coroutine_handle<promise_type> handle) noexcept {
+        auto &&promise = handle.promise();
+        if (promise.arrived.exchange(true)) {
+          return promise.consumer;
+        }
+        return std::noop_coroutine();
+      }
+      void await_resume() const noexcept {}
+    };
+
+    std::suspend_always initial_suspend() noexcept { return {}; }
+    HandoffAwaiter final_suspend() noexcept { return {}; }
+
+    HandoffAwaiter yield_value(std::vector<T> values) noexcept {
+      batch = std::move(values);
+      return {};
+    }
+
+    void return_void() noexcept {}
+    void unhandled_exception() noexcept { std::terminate(); }
+
+    std::vector<T> batch;
+    std::coroutine_handle<> consumer;
+    std::atomic<bool> arrived{false};
+  };
+
+ private:
+  using Handle = std::coroutine_handle<promise_type>;
+
+  // Yields the next batch, or nothing once the producer is finished
+  struct NextAwaiter {
+    bool await_ready() const noexcept { return false; }
+
+    std::coroutine_handle<> await_suspend(std::coroutine_handle<> awaiter) {
+      auto &&promise = handle.promise();
+      promise.consumer = awaiter;
+      if (pool == nullptr) {
+        promise.arrived.store(true);
+        return handle;
+      }
+      if (promise.arrived.exchange(true)) {
+        return awaiter;
+      }
+      return std::noop_coroutine();
+    }
+
+    std::optional<std::vector<T>> await_resume() {
+      if (handle.done()) {
+        return std::nullopt;
+      }
+      return std::move(handle.promise().batch);
+    }
+
+    Handle handle;
+    ThreadPool *pool;
+  };
+
+ public:
+  // Runs the producer inline until its next co_yield
+  NextAwaiter Next() {
+    _handle.promise().arrived.store(false);
+    return {_handle, nullptr};
+  }
+
+  // Starts the producer on the pool right away, await the result later
+  NextAwaiter Prefetch(ThreadPool &pool) {
+    _handle.promise().arrived.store(false);
+    pool.Post([handle = _handle] { handle.resume(); });
+    return {_handle, &pool};
+  }
+
+  AsyncGenerator(AsyncGenerator &&other) noexcept
+      : _handle(std::exchange(other._handle, {})) {}
+
+  AsyncGenerator(AsyncGenerator const &) = delete;
+  AsyncGenerator &operator=(AsyncGenerator const &) = delete;
+  AsyncGenerator &operator=(AsyncGenerator &&) = delete;
+
+  ~AsyncGenerator() {
+    if (_handle) {
+      _handle.destroy();
+    }
+  }
+
+ private:
+  explicit AsyncGenerator(Handle handle) : _handle(handle) {}
+
+  Handle _handle;
+};
+
+// Async Terminal Combinators
+
+namespace ranges {
+// Consumes an AsyncGenerator, the producer fills the next batch on the pool
+// while the current one is processed
+template <typename T, typename Func>
+Task<> ForEachAsync(AsyncGenerator<T> gen, ThreadPool &pool, Func func) {
+  auto batch = co_await gen.Next();
+  while (batch.has_value()) {
+    auto next = gen.Prefetch(pool);
+    for (auto &&element : *batch) {
+      std::invoke(func, element);
+    }
+    batch = co_await next;
+  }
+}
+
+// Runs a pipeline stage, e.g. ranges::Filter(...), over every batch and
+// collects the results in order
+template <typename T, typename Stage>
+auto CollectAsync(AsyncGenerator<T> gen, ThreadPool &pool, Stage stage)
+    -> Task<std::vector<GetValueType<
+        std::invoke_result_t<Stage &, View<std::vector<T> &>>>>> {
+  std::vector<GetValueType<
+      std::invoke_result_t<Stage &, View<std::vector<T> &>>>>
+      output;
+  auto batch = co_await gen.Next();
+  while (batch.has_value()) {
+    auto next = gen.Prefetch(pool);
+    for (auto &&element : stage(View{*batch})) {
+      output.push_back(element);
+    }
+    batch = co_await next;
+  }
+  co_return output;
+}
+}  // namespace ranges
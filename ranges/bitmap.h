@@ -0,0 +1,274 @@
+#pragma once
+#include <bit>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <iterator>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <tuple>
+#include <typeindex>
+#include <vector>
+
+#include "core.h"
+
+// Bitmap
+
+// Materialized predicate result over a random access source, one bit per
+// element. Bitmaps over the same source combine with & and |, and filtering
+// by a bitmap knows its exact size up front.
+
+class Bitmap {
+ public:
+  template <typename Range, typename Pred>  //
+  static Bitmap Build(Range &&range, Pred &&pred) {
+    static_assert(IsRandomAccess<Range>::value,
+                  "Bitmap could be built only over random access ranges");
+    auto it = std::begin(range);
+    Bitmap bitmap(static_cast<size_t>(Distance(it, std::end(range))));
+    size_t full = bitmap._size / kBits;
+    for (size_t word = 0; word < full; ++word, it += kBits) {
+      uint64_t bits = 0;
+      for (size_t bit = 0; bit < kBits; ++bit) {
+        bits |= static_cast<uint64_t>(static_cast<bool>(pred(it[bit]))) << bit;
+      }
+      bitmap._words[word] = bits;
+    }
+    for (size_t bit = 0; bit < bitmap._size % kBits; ++bit) {
+      bitmap._words[full] |=
+          static_cast<uint64_t>(static_cast<bool>(pred(it[bit]))) << bit;
+    }
+    bitmap.Recount();
+    return bitmap;
+  }
+
+  bool Test(size_t index) const {
+    return (_words[index / kBits] >> (index % kBits)) & 1;
+  }
+
+  // Number of set bits
+  size_t Count() const { return _count; }
+
+  size_t size() const  // NOLINT
+  {
+    return _size;
+  }
+
+  uint64_t const *Words() const { return _words.data(); }
+  size_t WordCount() const { return _words.size(); }
+
+  friend Bitmap operator&(Bitmap const &lhs, Bitmap const &rhs) {
+    return Combine(lhs, rhs, std::bit_and<>{});
+  }
+
+  friend Bitmap operator|(Bitmap const &lhs, Bitmap const &rhs) {
+    return Combine(lhs, rhs, std::bit_or<>{});
+  }
+
+  explicit Bitmap(size_t size)
+      : _words((size + kBits - 1) / kBits), _size(size) {}
+
+ private:
+  static constexpr size_t kBits = 64;
+
+  template <typename Op>  //
+  static Bitmap Combine(Bitmap const &lhs, Bitmap const &rhs, Op op) {
+    assert(lhs._size == rhs._size);
+    Bitmap result(lhs._size);
+    for (size_t word = 0; word < result._words.size(); ++word) {
+      result._words[word] = op(lhs._words[word], rhs._words[word]);
+    }
+    result.Recount();
+    return result;
+  }
+
+  void Recount() {
+    _count = 0;
+    for (auto &&word : _words) {
+      _count += static_cast<size_t>(std::popcount(word));
+    }
+  }
+
+  std::vector<uint64_t> _words;
+  size_t _size;
+  size_t _count = 0;
+};
+
+// BitmapView
+
+template <typename Range>
+class BitmapView : private SizedView<Range> {
+  struct BitmapSentinel {
+    size_t words;
+  };
+
+  // Walks the set bits, whole zero words are skipped at once
+  template <typename It>
+  struct BitmapIterator {
+    using iterator_category = std::forward_iterator_tag;
+    using value_type = typename It::value_type;
+    using difference_type = typename It::difference_type;
+    using reference = typename It::reference;
+    using pointer = typename It::pointer;
+
+    reference operator*() {
+      return base[static_cast<difference_type>(word * 64 +
+                                               std::countr_zero(bits))];
+    }
+
+    BitmapIterator &operator++() {
+      bits &= bits - 1;
+      Advance();
+      return *this;
+    }
+
+    BitmapIterator operator++(int)  // NOLINT
+    {
+      auto tmp = *this;
+      ++*this;
+      return tmp;
+    }
+
+    bool operator==(const BitmapIterator &rhs) const {
+      return word == rhs.word && bits == rhs.bits;
+    }
+    bool operator!=(const BitmapIterator &rhs) const { return !(*this == rhs); }
+
+    bool operator==(const BitmapSentinel &rhs) const {
+      return word >= rhs.words;
+    }
+    bool operator!=(const BitmapSentinel &rhs) const { return !(*this == rhs); }
+
+    void Advance() {
+      while (bits == 0 && ++word < words) {
+        bits = data[word];
+      }
+    }
+
+    BitmapIterator(It b, uint64_t const *d, size_t w)
+        : base(b), data(d), word(0), words(w), bits(w == 0 ? 0 : d[0]) {
+      Advance();
+    }
+
+    It base;
+    uint64_t const *data;
+    size_t word;
+    size_t words;
+    uint64_t bits;
+  };
+
+ public:
+  using iterator = BitmapIterator<GetIter<Range>>;
+  using sentinel = BitmapSentinel;
+
+  iterator begin()  // NOLINT
+  {
+    return {SizedView<Range>::begin(), _bitmap->Words(), _bitmap->WordCount()};
+  }
+
+  sentinel end()  // NOLINT
+  {
+    return {_bitmap->WordCount()};
+  }
+
+  // Exact
+  typename iterator::difference_type size() const  // NOLINT
+  {
+    return static_cast<typename iterator::difference_type>(_bitmap->Count());
+  }
+
+  SizeHint Hint() const { return SizeHint::Exactly(_bitmap->Count()); }
+
+  explicit BitmapView(Range &range, std::shared_ptr<Bitmap const> bitmap)
+      : SizedView<Range>(range), _bitmap(std::move(bitmap)) {
+    static_assert(IsRandomAccess<Range>::value,
+                  "FilterBy could be used only on random access ranges");
+    assert(static_cast<size_t>(SizedView<Range>::size()) == _bitmap->size());
+  }
+
+ private:
+  std::shared_ptr<Bitmap const> _bitmap;
+};
+template <typename Rng>  //
+BitmapView(Rng &&c, std::shared_ptr<Bitmap const>) -> BitmapView<Rng>;
+
+template <typename Range>
+struct IsView<BitmapView<Range>> : std::true_type {};
+template <typename Range>
+struct IsSized<BitmapView<Range>> : std::true_type {};
+
+namespace ranges {
+struct FilterBy {
+  template <typename Range>  //
+  auto operator()(Range &&range) {
+    return BitmapView{range, bitmap};
+  }
+
+  explicit FilterBy(std::shared_ptr<Bitmap const> b) : bitmap(std::move(b)) {}
+  explicit FilterBy(Bitmap b)
+      : bitmap(std::make_shared<Bitmap const>(std::move(b))) {}
+
+  std::shared_ptr<Bitmap const> bitmap;
+};
+}  // namespace ranges
+
+template <typename Range>  //
+inline auto FilterBy(Range &&range, std::shared_ptr<Bitmap const> bitmap) {
+  return ranges::FilterBy{std::move(bitmap)}(std::forward<Range>(range));
+}
+
+// BitmapCache
+
+// Bitmaps keyed by the source elements, a version supplied by the owner of
+// the source and the predicate type. The address of the elements alone could
+// come back for new data once the old buffer is freed, so the owner bumps
+// the version whenever the source is modified, reallocated or replaced.
+// Predicates of the same type with different state have to be told apart
+// with a tag. A bitmap is built once per key, outside the lock, so lookups of
+// other keys do not wait for it.
+
+class BitmapCache {
+  using Key =
+      std::tuple<void const *, size_t, uint64_t, std::type_index, size_t>;
+
+  struct Slot {
+    std::once_flag built;
+    std::shared_ptr<Bitmap const> bitmap;
+  };
+
+ public:
+  template <typename Range, typename Pred>  //
+  std::shared_ptr<Bitmap const> Get(Range &&range, Pred &&pred,
+                                    uint64_t version, size_t tag = 0) {
+    auto size =
+        static_cast<size_t>(Distance(std::begin(range), std::end(range)));
+    void const *data =
+        size == 0 ? nullptr : std::addressof(*std::begin(range));
+    Key key{data, size, version, typeid(std::decay_t<Pred>), tag};
+
+    std::shared_ptr<Slot> slot;
+    {
+      std::lock_guard lock{_mutex};
+      auto &&entry = _slots[key];
+      if (!entry) {
+        entry = std::make_shared<Slot>();
+      }
+      slot = entry;
+    }
+    std::call_once(slot->built, [&] {
+      slot->bitmap = std::make_shared<Bitmap const>(
+          Bitmap::Build(range, std::forward<Pred>(pred)));
+    });
+    return slot->bitmap;
+  }
+
+  void Clear() {
+    std::lock_guard lock{_mutex};
+    _slots.clear();
+  }
+
+ private:
+  std::mutex _mutex;
+  std::map<Key, std::shared_ptr<Slot>> _slots;
+};
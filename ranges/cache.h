@@ -0,0 +1,181 @@
+#pragma once
+#include <cstddef>
+#include <memory>
+#include <optional>
+#include <tuple>
+#include <utility>
+#include <vector>
+
+#include "core.h"
+
+// Cache
+
+// Materializes the upstream on first traversal and serves every later pass
+// from the buffer. The state is shared between copies of the view, so stages
+// built on top of it (e.g. Repeat) reuse the same buffer. With a non-zero
+// block size only the touched prefix of the upstream is evaluated. The
+// buffer grows in chunks that never move, so references to cached elements
+// stay valid as long as any copy of the view, however far other iterators
+// fill it.
+
+template <typename Range>
+class CacheView {
+  using value_type = GetValueType<Range>;
+
+  struct State {
+    static constexpr size_t kChunk = 1024;
+
+    explicit State(Range &range, size_t b) : source(range), block(b) {}
+
+    void Fill(size_t index) {
+      if (!it.has_value()) {
+        it.emplace(source.begin());
+        end.emplace(source.end());
+        chunks.reserve(source.Hint().Reservation() / kChunk + 1);
+        done = *it == *end;
+      }
+      while (!done && size <= index) {
+        for (size_t n = 0; (block == 0 || n < block) && *it != *end;
+             ++n, ++*it) {
+          if (size % kChunk == 0) {
+            chunks.emplace_back().reserve(kChunk);
+          }
+          chunks.back().emplace_back(**it);
+          ++size;
+        }
+        done = *it == *end;
+      }
+    }
+
+    // Filled part of the chunk holding index
+    std::pair<value_type const *, value_type const *> Span(size_t index) {
+      auto &&chunk = chunks[index / kChunk];
+      return {chunk.data() + index % kChunk, chunk.data() + chunk.size()};
+    }
+
+    SizedView<Range> source;
+    std::optional<GetIter<Range>> it;
+    std::optional<GetSentinel<Range>> end;
+    // Reserved once, filled up to capacity and never reallocated
+    std::vector<std::vector<value_type>> chunks;
+    size_t size = 0;
+    size_t block;
+    bool done = false;
+  };
+
+  struct CacheSentinel {};
+
+  struct CacheIterator {
+    using iterator_category = std::forward_iterator_tag;
+    using value_type = typename CacheView::value_type;
+    using difference_type = std::ptrdiff_t;
+    using reference = value_type const &;
+    using pointer = value_type const *;
+
+    reference operator*() { return *at; }
+
+    CacheIterator &operator++() {
+      ++index;
+      if (++at == last) {
+        if (index >= state->size) {
+          state->Fill(index);
+        }
+        Seek();
+      }
+      return *this;
+    }
+
+    // Points at index unless the upstream is exhausted there
+    void Seek() {
+      if (index < state->size) {
+        std::tie(at, last) = state->Span(index);
+      }
+    }
+
+    CacheIterator operator++(int)  // NOLINT
+    {
+      auto tmp = *this;
+      ++*this;
+      return tmp;
+    }
+
+    bool operator==(const CacheIterator &rhs) const {
+      return index == rhs.index;
+    }
+    bool operator!=(const CacheIterator &rhs) const { return !(*this == rhs); }
+
+    // Fill keeps index inside the buffer unless the upstream is exhausted
+    bool operator==(const CacheSentinel &) const {
+      return index == state->size;
+    }
+    bool operator!=(const CacheSentinel &rhs) const { return !(*this == rhs); }
+
+    State *state;
+    size_t index;
+    value_type const *at = nullptr;
+    value_type const *last = nullptr;
+  };
+
+ public:
+  using iterator = CacheIterator;
+  using sentinel = CacheSentinel;
+
+  iterator begin()  // NOLINT
+  {
+    _state->Fill(0);
+    iterator it{_state.get(), 0};
+    it.Seek();
+    return it;
+  }
+
+  sentinel end()  // NOLINT
+  {
+    return {};
+  }
+
+  // Exact, materializes the upstream unless already done
+  typename iterator::difference_type size() const  // NOLINT
+  {
+    return ranges::detail::SizeOf(*this);
+  }
+
+  // Exact once materialized, at least the buffered prefix before
+  SizeHint Hint() const {
+    auto buffered = _state->size;
+    if (_state->done) {
+      return SizeHint::Exactly(buffered);
+    }
+    auto hint = _state->source.Hint();
+    hint.lower = std::max(hint.lower, buffered);
+    return hint;
+  }
+
+  explicit CacheView(Range &range, size_t block = 0)
+      : _state(std::make_shared<State>(range, block)) {}
+
+ private:
+  std::shared_ptr<State> _state;
+};
+template <typename Rng>  //
+CacheView(Rng &&c, size_t) -> CacheView<Rng>;
+
+template <typename Range>
+struct IsView<CacheView<Range>> : std::true_type {};
+
+namespace ranges {
+struct Cache {
+  template <typename Range>  //
+  auto operator()(Range &&range) {
+    return CacheView{range, block};
+  }
+
+  explicit Cache(size_t b = 0) : block(b) {}
+
+  size_t block;
+};
+}  // namespace ranges
+
+template <typename Range>  //
+inline auto Cache(Range &&range, size_t block = 0) {
+  return ranges::Cache{block}(std::forward<Range>(range));
+}
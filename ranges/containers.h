@@ -0,0 +1,113 @@
+#pragma once
+#include <type_traits>
+#include <utility>
+
+#include "core.h"
+
+// Container Glue
+
+// Terminals use what a container offers itself instead of naming containers,
+// so they do not pull in <map>, <list> and friends:
+//   Find, Count   the member find and count of associative containers (those
+//                 with a key_type), not only std::map, std::multimap and
+//                 std::unordered_map; sets look up by their own equivalence
+//   Collect       push_back (and reserve) where the container has them, an
+//                 inserter otherwise, and a static Encode returning the
+//                 container, not only PackedColumn's
+// A type of your own opts in by providing these members.
+
+namespace ranges::detail {
+template <typename Range, typename = void>
+struct HasKeyType : std::false_type {};
+template <typename Range>
+struct HasKeyType<
+    Range, std::void_t<typename std::remove_reference_t<Range>::key_type>>
+    : std::true_type {};
+
+template <typename Range, typename T, typename = void>
+struct HasFind : std::false_type {};
+template <typename Range, typename T>
+struct HasFind<Range, T,
+               std::enable_if_t<HasKeyType<Range>::value &&
+                                std::is_convertible_v<
+                                    decltype(std::declval<Range &>().find(
+                                        std::declval<T>())),
+                                    GetIter<Range>>>> : std::true_type {};
+
+template <typename Range, typename T, typename = void>
+struct HasCount : std::false_type {};
+template <typename Range, typename T>
+struct HasCount<Range, T,
+                std::enable_if_t<HasKeyType<Range>::value &&
+                                 std::is_convertible_v<
+                                     decltype(std::declval<Range &>().count(
+                                         std::declval<T>())),
+                                     size_t>>> : std::true_type {};
+
+template <typename Container, typename = void>
+struct HasPushBack : std::false_type {};
+template <typename Container>
+struct HasPushBack<Container,
+                   std::void_t<decltype(std::declval<Container &>().push_back(
+                       std::declval<typename Container::value_type>()))>>
+    : std::true_type {};
+
+template <typename Container, typename = void>
+struct HasReserve : std::false_type {};
+template <typename Container>
+struct HasReserve<Container, std::void_t<decltype(std::declval<Container &>()
+                                                      .reserve(size_t{}))>>
+    : std::true_type {};
+
+// Ordered trees, e.g. std::map and std::set
+template <typename Container, typename = void>
+struct HasKeyComp : std::false_type {};
+template <typename Container>
+struct HasKeyComp<Container,
+                  std::void_t<decltype(std::declval<Container &>().key_comp()),
+                              decltype(std::declval<Container &>().emplace_hint(
+                                  std::declval<Container &>().end(),
+                                  std::declval<
+                                      typename Container::value_type>()))>>
+    : std::true_type {};
+
+template <typename Container, typename = void>
+struct HasMapped : std::false_type {};
+template <typename Container>
+struct HasMapped<Container, std::void_t<typename Container::mapped_type>>
+    : std::true_type {};
+
+// Sortable stand in for the value type, std::map's has a const key
+template <typename Container, typename = void>
+struct Sortable {
+  using type = typename Container::value_type;
+};
+template <typename Container>
+struct Sortable<Container, std::enable_if_t<HasMapped<Container>::value>> {
+  using type = std::pair<typename Container::key_type,
+                         typename Container::mapped_type>;
+};
+
+// e.g. PackedColumn, FlatMap, HashMap
+template <typename Container, typename Range, typename = void>
+struct IsEncodable : std::false_type {};
+template <typename Container, typename Range>
+struct IsEncodable<Container, Range,
+                   std::enable_if_t<std::is_same_v<
+                       decltype(Container::Encode(std::declval<Range &>())),
+                       Container>>> : std::true_type {};
+}  // namespace ranges::detail
+
+// Associative containers look up by key
+template <typename Range, typename T>  //
+auto Find(Range &&range, T &&key)
+    -> std::enable_if_t<ranges::detail::HasFind<Range, T>::value,
+                        GetIter<Range>> {
+  return range.find(std::forward<T>(key));
+}
+
+template <typename Range, typename T>  //
+auto Count(Range &&range, T &&key)
+    -> std::enable_if_t<ranges::detail::HasCount<Range, T>::value, size_t> {
+  return range.count(std::forward<T>(key));
+}
@@ -0,0 +1,484 @@
+#pragma once
+#include <algorithm>
+#include <cassert>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <functional>
+#include <iterator>
+#include <memory>
+#include <optional>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+/* concept Range
+{
+    std::begin(range)
+    std::end(range)
+}
+*/
+
+// Traits
+
+template <typename Rng>
+using GetIter = decltype(std::begin(std::declval<Rng &>()));
+
+template <typename Rng>
+using GetSentinel = decltype(std::end(std::declval<Rng &>()));
+
+template <typename Rng>
+using GetValueType = typename GetIter<Rng>::value_type;
+
+template <typename Rng>
+using GetIterReference = typename GetIter<Rng>::reference;
+
+template <typename, typename = void>
+struct IsRange : std::false_type {};
+template <typename Range>
+struct IsRange<Range, std::void_t<GetIter<Range>>> : std::true_type {};
+
+template <typename Range>
+struct IsRandomAccess
+    : std::is_same<
+          typename std::iterator_traits<GetIter<Range>>::iterator_category,
+          std::random_access_iterator_tag> {};
+
+template <typename Range, typename E = void>  //
+class View;
+
+template <typename>
+struct IsView : std::false_type {};
+template <typename Range>
+struct IsView<View<Range>> : std::true_type {};
+template <typename Range>
+struct IsView<Range &> : IsView<std::remove_reference_t<Range>> {};
+
+template <typename, typename = void>
+struct HasSize : std::false_type {};
+template <typename Range>
+struct HasSize<Range, std::void_t<decltype(std::size(std::declval<Range &>()))>>
+    : std::true_type {};
+
+// Whether size() is exact and answers without walking the range
+template <typename Range>
+struct IsSized
+    : std::disjunction<
+          IsRandomAccess<Range>,
+          std::conjunction<std::negation<IsView<Range>>, HasSize<Range>>> {};
+template <typename Range>
+struct IsSized<Range &> : IsSized<std::remove_reference_t<Range>> {};
+
+// Iterator-sentinel distance, std::distance needs both ends of the same type.
+// Sentinels that know the distance define end - it.
+
+template <typename It, typename Sent>  //
+inline typename std::iterator_traits<It>::difference_type Distance(It it,
+                                                                   Sent end) {
+  if constexpr (std::is_same_v<It, Sent>) {
+    return std::distance(it, end);
+  } else if constexpr (requires { end - it; }) {
+    return end - it;
+  } else {
+    typename std::iterator_traits<It>::difference_type count = 0;
+    for (; it != end; ++it) {
+      ++count;
+    }
+    return count;
+  }
+}
+
+// Size Hint
+
+// What a range knows about its length without walking it: a lower bound and,
+// when there is one, an upper bound. Equal bounds make the size exact. Views
+// report their hint with Hint() and combine the hint of their upstream.
+
+struct SizeHint {
+  size_t lower = 0;
+  std::optional<size_t> upper;
+
+  bool Exact() const { return upper == lower; }
+
+  // Capacity worth reserving up front
+  size_t Reservation() const { return upper.value_or(lower); }
+
+  // Some of the elements
+  SizeHint Subset() const { return {0, upper}; }
+
+  // At most count of the elements
+  SizeHint Cap(size_t count) const {
+    return {std::min(lower, count), std::min(upper.value_or(count), count)};
+  }
+
+  static SizeHint Exactly(size_t size) { return {size, size}; }
+
+  // Elements repeated count times
+  friend SizeHint operator*(SizeHint const &hint, size_t count) {
+    if (!hint.upper.has_value()) {
+      return {hint.lower * count, std::nullopt};
+    }
+    return {hint.lower * count, *hint.upper * count};
+  }
+};
+
+template <typename Range>  //
+inline SizeHint GetSizeHint(Range &&range) {
+  if constexpr (requires { range.Hint(); }) {
+    return range.Hint();
+  } else if constexpr (!IsView<Range>::value && HasSize<Range>::value) {
+    return SizeHint::Exactly(static_cast<size_t>(std::size(range)));
+  } else if constexpr (requires { std::end(range) - std::begin(range); }) {
+    return SizeHint::Exactly(
+        static_cast<size_t>(std::end(range) - std::begin(range)));
+  } else {
+    return {};
+  }
+}
+
+namespace ranges::detail {
+// Size of a view from its hint, the view is walked only when that is not exact
+template <typename Range>  //
+inline auto SizeOf(Range const &range) {
+  using Difference = typename GetIter<Range>::difference_type;
+  if (auto hint = range.Hint(); hint.Exact()) {
+    return static_cast<Difference>(hint.lower);
+  }
+  auto &walk = const_cast<Range &>(range);
+  return static_cast<Difference>(Distance(walk.begin(), walk.end()));
+}
+}  // namespace ranges::detail
+
+// Functor Wrapper
+
+template <typename F>  //
+struct IsFunctionPointer {
+  // NOLINTNEXTLINE
+  static const bool value =
+      std::is_pointer<F>::value
+          ? std::is_function<typename std::remove_pointer<F>::type>::value
+          : false;
+};
+
+template <typename F, typename = void>  //
+struct FunctorWrapper : public F {
+  explicit FunctorWrapper(F &&f) : F(std::move(f)) {}
+  explicit FunctorWrapper(F const &f) : F(f) {}
+};
+
+template <typename F>  //
+struct FunctorWrapperBase {
+  explicit FunctorWrapperBase(F &&f) : _impl(std::move(f)) {}
+  explicit FunctorWrapperBase(F const &f) : _impl(f) {}
+
+  template <typename... Args>  //
+  decltype(auto) operator()(Args &&...args) noexcept(
+      std::is_nothrow_invocable_v<F, Args &&...>) {
+    return std::invoke(_impl, std::forward<Args>(args)...);
+  }
+
+ private:
+  F _impl;
+};
+
+template <typename F>  //
+struct FunctorWrapper<F, std::enable_if_t<std::is_final_v<F>>>
+    : FunctorWrapperBase<F> {
+  using FunctorWrapperBase<F>::FunctorWrapperBase;
+};
+
+template <typename F>  //
+struct FunctorWrapper<F, std::enable_if_t<std::is_function_v<F>>>
+    : FunctorWrapperBase<std::decay_t<F>> {
+  using FunctorWrapperBase<std::decay_t<F>>::FunctorWrapperBase;
+};
+
+template <typename F>  //
+struct FunctorWrapper<F, std::enable_if_t<IsFunctionPointer<F>::value>>
+    : FunctorWrapperBase<F> {
+  using FunctorWrapperBase<F>::FunctorWrapperBase;
+};
+
+template <typename... Funcs>  //
+class Overloaded : private FunctorWrapper<Funcs>... {
+ public:
+  using FunctorWrapper<Funcs>::operator()...;
+
+  explicit Overloaded(Funcs... fns)
+      :  //
+        FunctorWrapper<Funcs>(std::move(fns))... {}
+};
+template <typename... Funcs>
+Overloaded(Funcs &&...) -> Overloaded<std::decay_t<Funcs>...>;
+
+// Functor Storage
+
+// Iterators keep stateless functors (empty base for lambdas) by value, and
+// small trivially copyable ones (a few captured scalars) too when they can be
+// called as const on the iterator's arguments, so copies have nothing to
+// diverge on. Other functors, heavy captures and mutable state, are reached
+// through a pointer to the one owned by their view: iterators of such a view
+// must not outlive it, and the terminals returning iterators reject it as a
+// temporary (BorrowsView).
+
+template <typename F>  //
+struct IsStateless
+    : std::bool_constant<std::is_empty_v<FunctorWrapper<F>> ||
+                         IsFunctionPointer<std::decay_t<F>>::value> {};
+
+// Cheap enough to copy into every iterator calling it with Args
+template <typename F, typename... Args>  //
+struct IsInlineFunctor
+    : std::bool_constant<
+          IsStateless<F>::value ||
+          (std::is_invocable_v<FunctorWrapper<F> const &, Args...> &&
+           std::is_trivially_copyable_v<FunctorWrapper<F>> &&
+           sizeof(FunctorWrapper<F>) <= 2 * sizeof(void *))> {};
+
+template <typename F, bool Inline,
+          bool Empty = std::is_empty_v<FunctorWrapper<F>>>  //
+struct FunctorStorage {
+  explicit FunctorStorage(FunctorWrapper<F> &f) : _impl(&f) {}
+
+  template <typename... Args>  //
+  decltype(auto) operator()(Args &&...args) const
+      noexcept(std::is_nothrow_invocable_v<FunctorWrapper<F> &, Args &&...>) {
+    return (*_impl)(std::forward<Args>(args)...);
+  }
+
+ private:
+  FunctorWrapper<F> *_impl;
+};
+
+// Iterators holding a functor are assignable even when it is not, as a
+// lambda is not: an empty one has nothing to assign, the others are
+// trivially copyable and their bytes are copied
+template <typename F>  //
+struct FunctorStorage<F, true, true> : FunctorWrapper<F> {
+  explicit FunctorStorage(FunctorWrapper<F> &f) : FunctorWrapper<F>(f) {}
+
+  FunctorStorage(FunctorStorage const &) = default;
+
+  FunctorStorage &operator=(FunctorStorage const &) { return *this; }
+};
+
+template <typename F>  //
+struct FunctorStorage<F, true, false> {
+  explicit FunctorStorage(FunctorWrapper<F> &f) : _impl(f) {}
+
+  FunctorStorage(FunctorStorage const &) = default;
+
+  FunctorStorage &operator=(FunctorStorage const &other) {
+    std::memcpy(static_cast<void *>(std::addressof(_impl)),
+                std::addressof(other._impl), sizeof(_impl));
+    return *this;
+  }
+
+  template <typename... Args>  //
+  decltype(auto) operator()(Args &&...args) noexcept(
+      std::is_nothrow_invocable_v<FunctorWrapper<F> &, Args &&...>) {
+    return _impl(std::forward<Args>(args)...);
+  }
+
+ private:
+  FunctorWrapper<F> _impl;
+};
+
+template <typename F, typename... Args>
+using FunctorRef = FunctorStorage<F, IsInlineFunctor<F, Args...>::value>;
+
+// Views whose iterators point back into the view itself. Views holding a
+// functor specialize it, views over an upstream view inherit it.
+
+template <typename Range>  //
+struct BorrowsView : std::false_type {};
+
+template <template <typename...> class V, typename Range, typename... Rest>
+struct BorrowsView<V<Range, Rest...>>
+    : std::conjunction<IsView<V<Range, Rest...>>,
+                       BorrowsView<std::decay_t<Range>>> {};
+
+// Sized
+
+// Containers that know their size without being random access (std::list,
+// std::map) have it recorded when a view is built over the whole container
+
+template <typename Range, typename E = void>
+class Sized {
+  using iterator = GetIter<Range>;
+
+ public:
+  std::optional<size_t> Recorded() const { return std::nullopt; }
+
+  explicit Sized(iterator b, GetSentinel<Range> e) {}
+
+  explicit Sized(Range &range) {}
+};
+
+template <typename Range>  //
+class Sized<Range, std::enable_if_t<!IsRandomAccess<Range>::value &&
+                                    !IsView<Range>::value &&
+                                    HasSize<Range>::value>> {
+  using iterator = GetIter<Range>;
+
+ public:
+  std::optional<size_t> Recorded() const { return _size; }
+
+  explicit Sized(iterator b, GetSentinel<Range> e) {}
+
+  explicit Sized(Range &range) : _size(std::size(range)) {}
+
+ private:
+  std::optional<size_t> _size;
+};
+
+// View
+
+template <typename Range>  //
+class View<Range, std::enable_if_t<!IsView<Range>::value>>
+    : private Sized<Range> {
+ public:
+  using iterator = GetIter<Range>;
+  using sentinel = GetSentinel<Range>;
+
+  iterator begin()  // NOLINT
+  {
+    return _begin;
+  }
+
+  sentinel end()  // NOLINT
+  {
+    return _end;
+  }
+
+  typename iterator::difference_type size() const  // NOLINT
+  {
+    return ranges::detail::SizeOf(*this);
+  }
+
+  // Exact when the size is recorded or the ends know their distance
+  SizeHint Hint() const {
+    if (auto size = Sized<Range>::Recorded()) {
+      return SizeHint::Exactly(*size);
+    }
+    if constexpr (requires { _end - _begin; }) {
+      return SizeHint::Exactly(static_cast<size_t>(_end - _begin));
+    } else {
+      return {};
+    }
+  }
+
+  explicit View(iterator b, sentinel e)
+      : Sized<Range>(b, e), _begin(b), _end(e) {}
+
+  explicit View(Range &range)
+      : Sized<Range>(range), _begin(std::begin(range)), _end(std::end(range)) {}
+
+ private:
+  iterator _begin;
+  sentinel _end;
+};
+
+template <typename Range>  //
+class View<Range, std::enable_if_t<IsView<Range>::value>>
+    : public std::remove_reference_t<Range> {
+  using Underlying = std::remove_reference_t<Range>;
+
+ public:
+  explicit View(Underlying &range) : Underlying(range) {}
+};
+template <typename Rng>
+View(Rng &&) -> View<Rng>;
+
+template <typename Range>  //
+class SizedView : private View<Range> {
+ public:
+  using iterator = GetIter<Range>;
+  using sentinel = GetSentinel<Range>;
+
+  using View<Range>::begin;
+  using View<Range>::end;
+
+  // Exact, walks the range only when the hint is not
+  typename iterator::difference_type size() const  // NOLINT
+  {
+    return ranges::detail::SizeOf(*this);
+  }
+
+  SizeHint Hint() const {
+    return GetSizeHint(static_cast<View<Range> const &>(*this));
+  }
+
+  // Upstream view, used by the pipeline rewriter
+  auto &Base() {
+    if constexpr (IsView<Range>::value) {
+      return static_cast<std::remove_reference_t<Range> &>(
+          static_cast<View<Range> &>(*this));
+    } else {
+      return static_cast<View<Range> &>(*this);
+    }
+  }
+
+  explicit SizedView(iterator b, sentinel e) : View<Range>(b, e) {}
+
+  explicit SizedView(Range &range) : View<Range>(range) {}
+};
+
+template <typename Range>  //
+class SizedView<SizedView<Range>> : public SizedView<Range> {};
+
+template <typename Rng>
+SizedView(Rng &&) -> SizedView<Rng>;
+
+template <typename Range>
+struct IsView<SizedView<Range>> : std::true_type {};
+template <typename Range>
+struct IsSized<SizedView<Range>> : IsSized<Range> {};
+
+// OwningView
+
+template <typename Range>  //
+class OwningView : private std::vector<GetValueType<Range>> {
+  using Inner = std::vector<GetValueType<Range>>;
+
+ public:
+  using typename Inner::iterator;
+  using typename Inner::value_type;
+
+  using Inner::begin;
+  using Inner::end;
+  using Inner::size;
+
+  explicit OwningView(Range &&range) {
+    Inner::reserve(GetSizeHint(range).Reservation());
+    for (auto &&element : range) {
+      Inner::emplace_back(std::move(element));
+    }
+  }
+};
+
+template <typename Range>  //
+class OwningView<OwningView<Range>> : public OwningView<Range> {};
+
+// RefCountView
+
+template <typename Range>  //
+struct RefCountView : SizedView<Range> {
+ public:
+  RefCountView(int &rc, Range &rng)  //
+      : SizedView<Range>(rng), ref_count(rc) {
+    ref_count++;
+  }
+
+  ~RefCountView() { ref_count--; }
+
+ private:
+  int &ref_count;
+};
+template <typename Rng>  //
+RefCountView(int &rc, Rng &&) -> RefCountView<Rng>;
+
+template <typename Range>
+struct IsView<RefCountView<Range>> : std::true_type {};
+template <typename Range>
+struct IsSized<RefCountView<Range>> : IsSized<SizedView<Range>> {};
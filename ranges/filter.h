@@ -0,0 +1,132 @@
+#pragma once
+#include <functional>
+#include <utility>
+
+#include "core.h"
+
+// Filter
+
+// Iterators may point back to the predicate of their view (Functor Storage
+// in core.h), so they must not outlive the view.
+
+template <typename Range, typename Pred>  //
+class FilterView : private SizedView<Range>, private FunctorWrapper<Pred> {
+  // How iterators over It hold the functor
+  template <typename It>  //
+  using IterFunctor = FunctorRef<Pred, typename It::reference>;
+
+  template <typename Sent>  //
+  struct FilterSentinel {
+    Sent end;
+  };
+
+  template <typename It, typename Sent>  //
+  struct FilterIterator : private IterFunctor<It> {
+    using iterator_category = std::forward_iterator_tag;
+    using value_type = typename It::value_type;
+    using difference_type = typename It::difference_type;
+    using reference = typename It::reference;
+    using pointer = typename It::pointer;
+
+    FilterIterator(FunctorWrapper<Pred> &p, It i, Sent e)
+        : IterFunctor<It>(p), it(i), end(e) {
+      Advance();
+    }
+
+    reference operator*() { return *it; }
+
+    FilterIterator &operator++() {
+      ++it;
+      Advance();
+      return *this;
+    }
+
+    FilterIterator operator++(int)  // NOLINT
+    {
+      auto tmp = *this;
+      ++*this;
+      return tmp;
+    }
+
+    bool operator==(const FilterIterator &rhs) const { return it == rhs.it; }
+    bool operator!=(const FilterIterator &rhs) const { return !(*this == rhs); }
+
+    bool operator==(const FilterSentinel<Sent> &rhs) const {
+      return it == rhs.end;
+    }
+    bool operator!=(const FilterSentinel<Sent> &rhs) const {
+      return !(*this == rhs);
+    }
+
+    void Advance() {
+      while (!(it == end) && !IterFunctor<It>::operator()(*it)) {
+        ++it;
+      }
+    }
+
+    It it;
+    Sent end;
+  };
+
+ public:
+  using iterator = FilterIterator<GetIter<Range>, GetSentinel<Range>>;
+  using sentinel = FilterSentinel<GetSentinel<Range>>;
+
+  iterator begin()  // NOLINT
+  {
+    return {static_cast<FunctorWrapper<Pred> &>(*this),
+            SizedView<Range>::begin(), SizedView<Range>::end()};
+  }
+
+  sentinel end()  // NOLINT
+  {
+    return {SizedView<Range>::end()};
+  }
+
+  // Exact, walks the range and so evaluates the predicate
+  typename iterator::difference_type size() const  // NOLINT
+  {
+    return ranges::detail::SizeOf(*this);
+  }
+
+  // At most the upstream
+  SizeHint Hint() const { return SizedView<Range>::Hint().Subset(); }
+
+  using SizedView<Range>::Base;
+  FunctorWrapper<Pred> &Functor() { return *this; }
+
+  template <typename P>
+  explicit FilterView(Range &range, P &&pred)
+      : SizedView<Range>(range),  //
+        FunctorWrapper<Pred>(std::forward<P>(pred)) {}
+};
+template <typename Rng, typename Pred>  //
+FilterView(Rng &&c, Pred &&p) -> FilterView<Rng, std::remove_reference_t<Pred>>;
+
+template <typename Range, typename Pred>
+struct IsView<FilterView<Range, Pred>> : std::true_type {};
+template <typename Range, typename Pred>
+struct BorrowsView<FilterView<Range, Pred>>
+    : std::disjunction<
+          std::negation<IsInlineFunctor<Pred, GetIterReference<Range>>>,
+          BorrowsView<std::decay_t<Range>>> {};
+
+namespace ranges {
+template <typename Pred>
+struct Filter : private FunctorWrapper<Pred> {
+  template <typename Range>  //
+  auto operator()(Range &&range) {
+    return FilterView{range, Functor()};
+  }
+
+  FunctorWrapper<Pred> &Functor() { return *this; }
+
+  explicit Filter(Pred &&p) : FunctorWrapper<Pred>(std::move(p)) {}
+  explicit Filter(Pred const &p) : FunctorWrapper<Pred>(p) {}
+};
+}  // namespace ranges
+
+template <typename Range, typename Pred>  //
+inline auto Filter(Range &&range, Pred &&op) {
+  return ranges::Filter(std::forward<Pred>(op))(std::forward<Range>(range));
+}
@@ -0,0 +1,144 @@
+#pragma once
+#include <functional>
+#include <optional>
+#include <utility>
+
+#include "core.h"
+
+// FilterMap
+
+// Like Filter and Map, iterators may refer to the view's functor and must
+// not outlive the view.
+
+template <typename Range, typename Func>  //
+class FilterMapView : private SizedView<Range>, private FunctorWrapper<Func> {
+  // How iterators over It hold the functor
+  template <typename It>  //
+  using IterFunctor = FunctorRef<Func, typename It::reference>;
+
+  template <typename Sent>  //
+  struct FilterMapSentinel {
+    Sent end;
+  };
+
+  template <typename It, typename Sent>  //
+  struct FilterMapIterator : private IterFunctor<It> {
+    using iterator_category = std::forward_iterator_tag;
+
+    using reference =
+        typename std::invoke_result_t<Func, typename It::reference>::value_type;
+
+    using value_type = std::decay_t<reference>;
+    using pointer = value_type *;
+    using difference_type = typename It::difference_type;
+
+    FilterMapIterator(FunctorWrapper<Func> &f, It i, Sent e)
+        : IterFunctor<It>(f), it(i), end(e) {
+      Advance();
+    }
+
+    reference operator*() { return current.value(); }
+
+    FilterMapIterator &operator++() {
+      ++it;
+      Advance();
+      return *this;
+    }
+
+    FilterMapIterator operator++(int)  // NOLINT
+    {
+      auto tmp = *this;
+      ++*this;
+      return tmp;
+    }
+
+    bool operator==(const FilterMapIterator &rhs) const { return it == rhs.it; }
+    bool operator!=(const FilterMapIterator &rhs) const {
+      return !(*this == rhs);
+    }
+
+    bool operator==(const FilterMapSentinel<Sent> &rhs) const {
+      return it == rhs.end;
+    }
+    bool operator!=(const FilterMapSentinel<Sent> &rhs) const {
+      return !(*this == rhs);
+    }
+
+    void Advance() {
+      while (!(it == end)) {
+        current = IterFunctor<It>::operator()(*it);
+        if (current.has_value()) {
+          break;
+        }
+        ++it;
+      }
+    }
+
+    It it;
+    Sent end;
+    std::optional<value_type> current;
+  };
+
+ public:
+  using iterator = FilterMapIterator<GetIter<Range>, GetSentinel<Range>>;
+  using sentinel = FilterMapSentinel<GetSentinel<Range>>;
+
+  iterator begin()  // NOLINT
+  {
+    return {static_cast<FunctorWrapper<Func> &>(*this),
+            SizedView<Range>::begin(), SizedView<Range>::end()};
+  }
+
+  sentinel end()  // NOLINT
+  {
+    return {SizedView<Range>::end()};
+  }
+
+  // Exact, walks the range and so evaluates the function
+  typename iterator::difference_type size() const  // NOLINT
+  {
+    return ranges::detail::SizeOf(*this);
+  }
+
+  // At most the upstream
+  SizeHint Hint() const { return SizedView<Range>::Hint().Subset(); }
+
+  using SizedView<Range>::Base;
+  FunctorWrapper<Func> &Functor() { return *this; }
+
+  template <typename P>
+  explicit FilterMapView(Range &range, P &&func)
+      : SizedView<Range>(range),  //
+        FunctorWrapper<Func>(std::forward<P>(func)) {}
+};
+template <typename Rng, typename Func>  //
+FilterMapView(Rng &&c, Func &&p)
+    -> FilterMapView<Rng, std::remove_reference_t<Func>>;
+
+template <typename Range, typename Func>
+struct IsView<FilterMapView<Range, Func>> : std::true_type {};
+template <typename Range, typename Func>
+struct BorrowsView<FilterMapView<Range, Func>>
+    : std::disjunction<
+          std::negation<IsInlineFunctor<Func, GetIterReference<Range>>>,
+          BorrowsView<std::decay_t<Range>>> {};
+
+namespace ranges {
+template <typename Func>
+struct FilterMap : private FunctorWrapper<Func> {
+  template <typename Range>  //
+  auto operator()(Range &&range) {
+    return FilterMapView{range, Functor()};
+  }
+
+  FunctorWrapper<Func> &Functor() { return *this; }
+
+  explicit FilterMap(Func &&p) : FunctorWrapper<Func>(std::move(p)) {}
+  explicit FilterMap(Func const &p) : FunctorWrapper<Func>(p) {}
+};
+}  // namespace ranges
+
+template <typename Range, typename Func>  //
+inline auto FilterMap(Range &&range, Func &&op) {
+  return ranges::FilterMap(std::forward<Func>(op))(std::forward<Range>(range));
+}
@@ -0,0 +1,151 @@
+#pragma once
+#include <algorithm>
+#include <cstddef>
+#include <functional>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+#include "core.h"
+
+// FlatSet, FlatMap
+
+// Sorted vectors with unique keys. Lookups are binary searches over
+// contiguous memory and iteration is a plain vector walk. A single insert
+// shifts the tail, so tables are meant to be built whole: Collect sorts the
+// input once and keeps the first of equal keys, as inserting one by one
+// would. Keys must not be changed through iterators.
+
+namespace ranges::detail {
+struct PairFirst {
+  template <typename Pair>  //
+  auto const &operator()(Pair const &pair) const {
+    return pair.first;
+  }
+};
+}  // namespace ranges::detail
+
+template <typename Value, typename KeyOf, typename Cmp>
+class FlatTable {
+ public:
+  using value_type = Value;
+  using key_type = std::decay_t<std::invoke_result_t<KeyOf, Value const &>>;
+  using iterator = typename std::vector<Value>::iterator;
+  using const_iterator = typename std::vector<Value>::const_iterator;
+
+  template <typename Range>  //
+  static FlatTable Encode(Range &&range) {
+    FlatTable table;
+    auto &&values = table._values;
+    values.reserve(GetSizeHint(range).Reservation());
+    for (auto it = std::begin(range), end = std::end(range); it != end; ++it) {
+      values.emplace_back(*it);
+    }
+    std::stable_sort(values.begin(), values.end(), table.Less());
+    values.erase(std::unique(values.begin(), values.end(),
+                             [&](auto const &lhs, auto const &rhs) {
+                               return !table.Less()(lhs, rhs);
+                             }),
+                 values.end());
+    return table;
+  }
+
+  iterator begin()  // NOLINT
+  {
+    return _values.begin();
+  }
+  const_iterator begin() const  // NOLINT
+  {
+    return _values.begin();
+  }
+
+  iterator end()  // NOLINT
+  {
+    return _values.end();
+  }
+  const_iterator end() const  // NOLINT
+  {
+    return _values.end();
+  }
+
+  size_t size() const  // NOLINT
+  {
+    return _values.size();
+  }
+
+  bool empty() const  // NOLINT
+  {
+    return _values.empty();
+  }
+
+  iterator lower_bound(key_type const &key)  // NOLINT
+  {
+    return std::lower_bound(_values.begin(), _values.end(), key,
+                            [&](Value const &value, key_type const &k) {
+                              return _cmp(KeyOf{}(value), k);
+                            });
+  }
+  const_iterator lower_bound(key_type const &key) const  // NOLINT
+  {
+    return const_cast<FlatTable &>(*this).lower_bound(key);
+  }
+
+  iterator find(key_type const &key)  // NOLINT
+  {
+    auto it = lower_bound(key);
+    if (it == _values.end() || _cmp(key, KeyOf{}(*it))) {
+      return _values.end();
+    }
+    return it;
+  }
+  const_iterator find(key_type const &key) const  // NOLINT
+  {
+    return const_cast<FlatTable &>(*this).find(key);
+  }
+
+  bool contains(key_type const &key) const  // NOLINT
+  {
+    return find(key) != end();
+  }
+
+  size_t count(key_type const &key) const  // NOLINT
+  {
+    return contains(key) ? 1 : 0;
+  }
+
+  // Shifts the tail, linear
+  std::pair<iterator, bool> insert(Value value)  // NOLINT
+  {
+    auto it = lower_bound(KeyOf{}(value));
+    if (it != _values.end() && !_cmp(KeyOf{}(value), KeyOf{}(*it))) {
+      return {it, false};
+    }
+    return {_values.insert(it, std::move(value)), true};
+  }
+
+  template <typename V = Value>  //
+  auto operator[](key_type const &key)
+      -> decltype(std::declval<V &>().second) & {
+    auto it = lower_bound(key);
+    if (it == _values.end() || _cmp(key, KeyOf{}(*it))) {
+      it = _values.insert(it, Value{key, {}});
+    }
+    return it->second;
+  }
+
+ private:
+  auto Less() const {
+    return [this](Value const &lhs, Value const &rhs) {
+      return _cmp(KeyOf{}(lhs), KeyOf{}(rhs));
+    };
+  }
+
+  std::vector<Value> _values;
+  [[no_unique_address]] Cmp _cmp;
+};
+
+template <typename T, typename Cmp = std::less<T>>
+using FlatSet = FlatTable<T, std::identity, Cmp>;
+
+template <typename K, typename V, typename Cmp = std::less<K>>
+using FlatMap = FlatTable<std::pair<K, V>, ranges::detail::PairFirst, Cmp>;
@@ -0,0 +1,123 @@
+#pragma once
+#include <utility>
+
+#include "core.h"
+
+// Flatten
+
+template <typename Range>
+class FlattenView : private View<Range> {
+  template <typename Sent>  //
+  struct FlattenSentinel {
+    Sent end;
+  };
+
+  template <typename It, typename Sent>  //
+  struct FlattenIterator {
+    using UnderlyingIt = typename It::value_type::iterator;
+    using iterator_category = std::forward_iterator_tag;
+    using value_type = typename UnderlyingIt::value_type;
+    using difference_type = typename UnderlyingIt::difference_type;
+    using reference = typename UnderlyingIt::reference;
+    using pointer = typename UnderlyingIt::pointer;
+
+    reference operator*() { return *inner; }
+
+    FlattenIterator &operator++() {
+      if (it != end && inner_end == ++inner) {
+        ++it;
+        Init();
+      }
+      return *this;
+    }
+
+    FlattenIterator operator++(int)  // NOLINT
+    {
+      auto tmp = *this;
+      ++*this;
+      return tmp;
+    }
+
+    bool operator==(const FlattenIterator &rhs) const {
+      return it == rhs.it && (it == end ? true : inner == rhs.inner);
+    }
+    bool operator!=(const FlattenIterator &rhs) const {
+      return !(*this == rhs);
+    }
+
+    bool operator==(const FlattenSentinel<Sent> &rhs) const {
+      return it == rhs.end;
+    }
+    bool operator!=(const FlattenSentinel<Sent> &rhs) const {
+      return !(*this == rhs);
+    }
+
+    FlattenIterator(It i, Sent e) : it(i), end(e) { Init(); }
+
+    void Init() {
+      if (it == end) {
+        return;
+      }
+      auto &&temp = *it;
+      inner = std::begin(temp);
+      inner_end = std::end(temp);
+    }
+
+    It it;
+    Sent end;
+    UnderlyingIt inner;
+    UnderlyingIt inner_end;
+  };
+
+ public:
+  using iterator = FlattenIterator<GetIter<Range>, GetSentinel<Range>>;
+  using sentinel = FlattenSentinel<GetSentinel<Range>>;
+
+  iterator begin()  // NOLINT
+  {
+    return {View<Range>::begin(), View<Range>::end()};
+  }
+
+  sentinel end()  // NOLINT
+  {
+    return {View<Range>::end()};
+  }
+
+  // Exact, walks the outer and every inner range
+  typename iterator::difference_type size() const  // NOLINT
+  {
+    return ranges::detail::SizeOf(*this);
+  }
+
+  // Unknown unless there is nothing to flatten
+  SizeHint Hint() const {
+    if (GetSizeHint(static_cast<View<Range> const &>(*this)).upper == 0) {
+      return SizeHint::Exactly(0);
+    }
+    return {};
+  }
+
+  explicit FlattenView(Range &range) : View<Range>(range) {
+    static_assert(IsRange<GetValueType<Range>>::value,
+                  "Flatten could be used only on nested ranges");
+  }
+};
+template <typename Rng>  //
+FlattenView(Rng &&c) -> FlattenView<Rng>;
+
+template <typename Range>
+struct IsView<FlattenView<Range>> : std::true_type {};
+
+namespace ranges {
+struct Flatten {
+  template <typename Range>  //
+  auto operator()(Range &&range) {
+    return FlattenView{range};
+  }
+};
+}  // namespace ranges
+
+template <typename Range>  //
+inline auto Flatten(Range &&range) {
+  return ranges::Flatten{}(std::forward<Range>(range));
+}
@@ -0,0 +1,139 @@
+#pragma once
+#include <coroutine>
+#include <cstddef>
+#include <memory>
+#include <span>
+#include <utility>
+
+#include "core.h"
+
+// Generator
+
+// Synchronous coroutine source. A single co_yield hands out one element, a
+// co_yield of a span hands out a whole batch and the coroutine is resumed
+// only once the batch is consumed. Copies share the coroutine, so the
+// generator is single pass like any input range.
+
+template <typename T>
+class Generator {
+ public:
+  struct promise_type {
+    Generator get_return_object() {
+      return Generator{
+          std::coroutine_handle<promise_type>::from_promise(*this)};
+    }
+
+    std::suspend_always initial_suspend() noexcept { return {}; }
+    std::suspend_always final_suspend() noexcept { return {}; }
+
+    // The yielded temporary outlives the suspension
+    std::suspend_always yield_value(T const &value) noexcept {
+      batch = &value;
+      count = 1;
+      index = 0;
+      return {};
+    }
+
+    std::suspend_always yield_value(std::span<T const> values) noexcept {
+      batch = values.data();
+      count = values.size();
+      index = 0;
+      return {};
+    }
+
+    void return_void() noexcept {}
+    void unhandled_exception() noexcept { std::terminate(); }
+
+    // Resumes until there is an element to read or the body is finished
+    void Pull(std::coroutine_handle<promise_type> handle) {
+      do {
+        count = 0;
+        handle.resume();
+      } while (!handle.done() && count == 0);
+    }
+
+    T const *batch = nullptr;
+    size_t count = 0;
+    size_t index = 0;
+    bool started = false;
+  };
+
+ private:
+  using Handle = std::coroutine_handle<promise_type>;
+
+  struct GeneratorSentinel {};
+
+  struct GeneratorIterator {
+    using iterator_category = std::input_iterator_tag;
+    using value_type = T;
+    using difference_type = std::ptrdiff_t;
+    using reference = T const &;
+    using pointer = T const *;
+
+    reference operator*() {
+      auto &&promise = handle.promise();
+      return promise.batch[promise.index];
+    }
+
+    GeneratorIterator &operator++() {
+      auto &&promise = handle.promise();
+      if (++promise.index == promise.count) {
+        promise.Pull(handle);
+      }
+      return *this;
+    }
+
+    void operator++(int)  // NOLINT
+    {
+      ++*this;
+    }
+
+    bool operator==(const GeneratorIterator &rhs) const {
+      return handle == rhs.handle;
+    }
+    bool operator!=(const GeneratorIterator &rhs) const {
+      return !(*this == rhs);
+    }
+
+    bool operator==(const GeneratorSentinel &) const { return handle.done(); }
+    bool operator!=(const GeneratorSentinel &rhs) const {
+      return !(*this == rhs);
+    }
+
+    Handle handle;
+  };
+
+ public:
+  using iterator = GeneratorIterator;
+  using sentinel = GeneratorSentinel;
+
+  iterator begin()  // NOLINT
+  {
+    auto &&promise = _handle.promise();
+    if (!promise.started) {
+      promise.started = true;
+      promise.Pull(_handle);
+    }
+    return {_handle};
+  }
+
+  sentinel end()  // NOLINT
+  {
+    return {};
+  }
+
+  // Unknown up front
+  SizeHint Hint() const { return {}; }
+
+ private:
+  explicit Generator(Handle handle)
+      : _handle(handle), _frame(handle.address(), [](void *frame) {
+          Handle::from_address(frame).destroy();
+        }) {}
+
+  Handle _handle;
+  std::shared_ptr<void> _frame;
+};
+
+template <typename T>
+struct IsView<Generator<T>> : std::true_type {};
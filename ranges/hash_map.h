@@ -0,0 +1,180 @@
+#pragma once
+#include <bit>
+#include <cassert>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <limits>
+#include <utility>
+#include <vector>
+
+#include "core.h"
+
+// HashMap
+
+// Open addressing with linear probing. Entries are kept densely in insertion
+// order, so iteration is a vector walk. The probe table keeps 32 bits of the
+// hash next to each entry index, so most mismatches are rejected without
+// touching the entry. There is no erase. Keys must not be changed through
+// iterators.
+
+template <typename K, typename V, typename Hash = std::hash<K>,
+          typename Eq = std::equal_to<K>>
+class HashMap {
+  // Upper half tag, lower half entry index + 1, zero when empty
+  using Slot = uint64_t;
+
+  static constexpr size_t kMinCapacity = 8;
+
+ public:
+  using key_type = K;
+  using mapped_type = V;
+  using value_type = std::pair<K, V>;
+  using iterator = typename std::vector<value_type>::iterator;
+  using const_iterator = typename std::vector<value_type>::const_iterator;
+
+  // Sized from the hint once, equal keys keep the first value
+  template <typename Range>  //
+  static HashMap Encode(Range &&range) {
+    HashMap map;
+    map.reserve(GetSizeHint(range).Reservation());
+    for (auto it = std::begin(range), end = std::end(range); it != end; ++it) {
+      map.insert(*it);
+    }
+    return map;
+  }
+
+  iterator begin()  // NOLINT
+  {
+    return _entries.begin();
+  }
+  const_iterator begin() const  // NOLINT
+  {
+    return _entries.begin();
+  }
+
+  iterator end()  // NOLINT
+  {
+    return _entries.end();
+  }
+  const_iterator end() const  // NOLINT
+  {
+    return _entries.end();
+  }
+
+  size_t size() const  // NOLINT
+  {
+    return _entries.size();
+  }
+
+  bool empty() const  // NOLINT
+  {
+    return _entries.empty();
+  }
+
+  void reserve(size_t count)  // NOLINT
+  {
+    _entries.reserve(count);
+    if (Crowded(count)) {
+      Rehash(count);
+    }
+  }
+
+  iterator find(K const &key)  // NOLINT
+  {
+    if (_slots.empty()) {
+      return _entries.end();
+    }
+    auto slot = _slots[Probe(key, Mix(key))];
+    return slot == 0 ? _entries.end() : _entries.begin() + Index(slot);
+  }
+  const_iterator find(K const &key) const  // NOLINT
+  {
+    return const_cast<HashMap &>(*this).find(key);
+  }
+
+  bool contains(K const &key) const  // NOLINT
+  {
+    return find(key) != end();
+  }
+
+  size_t count(K const &key) const  // NOLINT
+  {
+    return contains(key) ? 1 : 0;
+  }
+
+  std::pair<iterator, bool> insert(value_type value)  // NOLINT
+  {
+    if (Crowded(_entries.size() + 1)) {
+      Rehash(_entries.size() + 1);
+    }
+    auto hash = Mix(value.first);
+    auto &&slot = _slots[Probe(value.first, hash)];
+    if (slot != 0) {
+      return {_entries.begin() + Index(slot), false};
+    }
+    assert(_entries.size() < std::numeric_limits<uint32_t>::max());
+    slot = Tag(hash) | (_entries.size() + 1);
+    _entries.push_back(std::move(value));
+    return {_entries.end() - 1, true};
+  }
+
+  V &operator[](K const &key) {
+    auto it = find(key);
+    if (it == _entries.end()) {
+      it = insert({key, V{}}).first;
+    }
+    return it->second;
+  }
+
+ private:
+  uint64_t Mix(K const &key) const {
+    return static_cast<uint64_t>(_hash(key)) * 0x9E3779B97F4A7C15ULL;
+  }
+
+  static Slot Tag(uint64_t hash) { return hash << 32; }
+
+  static size_t Index(Slot slot) { return (slot & 0xFFFFFFFFU) - 1; }
+
+  // Load factor stays below 3/4
+  bool Crowded(size_t count) const {
+    return count * 4 > _slots.size() * 3;
+  }
+
+  // Slot holding key, or the empty slot it would go to. The top bits of the
+  // mixed hash pick the start, they depend on every bit of the key's hash.
+  size_t Probe(K const &key, uint64_t hash) const {
+    size_t mask = _slots.size() - 1;
+    for (size_t slot = hash >> _shift;; slot = (slot + 1) & mask) {
+      auto entry = _slots[slot];
+      if (entry == 0 || ((entry ^ Tag(hash)) >> 32 == 0 &&
+                         _eq(_entries[Index(entry)].first, key))) {
+        return slot;
+      }
+    }
+  }
+
+  void Rehash(size_t count) {
+    size_t capacity = kMinCapacity;
+    while (count * 4 > capacity * 3) {
+      capacity *= 2;
+    }
+    _slots.assign(capacity, 0);
+    _shift = 64 - std::countr_zero(capacity);
+    size_t mask = capacity - 1;
+    for (size_t index = 0; index < _entries.size(); ++index) {
+      auto hash = Mix(_entries[index].first);
+      auto slot = hash >> _shift;
+      while (_slots[slot] != 0) {
+        slot = (slot + 1) & mask;
+      }
+      _slots[slot] = Tag(hash) | (index + 1);
+    }
+  }
+
+  std::vector<Slot> _slots;
+  std::vector<value_type> _entries;
+  int _shift = 64;
+  [[no_unique_address]] Hash _hash;
+  [[no_unique_address]] Eq _eq;
+};
@@ -0,0 +1,142 @@
+#pragma once
+#include <cstddef>
+#include <cstdint>
+#include <new>
+#include <type_traits>
+#include <utility>
+#include <vector>
+#ifdef __linux__
+#include <sys/mman.h>
+#include <unistd.h>
+#endif
+
+#include "core.h"
+
+// HugePageAllocator
+
+// Allocator for large outputs, e.g. Collect<HugePageVector<T>>. Blocks of at
+// least a huge page are mapped on 2 MiB boundaries and advised as huge pages,
+// so a 800 MB buffer takes about 400 faults instead of 200k. By default the
+// pages are faulted in at allocation, in one call; a lazy allocator leaves
+// them to the first write, which the parallel Collect spreads over the
+// threads filling them. Elements constructed without arguments are default
+// initialized, so resizing over trivial types writes nothing. Smaller blocks,
+// and every block off Linux, come from operator new.
+
+template <typename T>
+class HugePageAllocator {
+ public:
+  using value_type = T;
+
+  static constexpr size_t kHugePage = size_t{1} << 21;
+
+  T *allocate(size_t n) {
+    size_t bytes = n * sizeof(T);
+#ifdef __linux__
+    if (bytes >= kHugePage) {
+      return static_cast<T *>(Map(Rounded(bytes)));
+    }
+#endif
+    return static_cast<T *>(
+        ::operator new(bytes, std::align_val_t{alignof(T)}));
+  }
+
+  void deallocate(T *ptr, size_t n) noexcept {
+    size_t bytes = n * sizeof(T);
+#ifdef __linux__
+    if (bytes >= kHugePage) {
+      munmap(ptr, Rounded(bytes));
+      return;
+    }
+#endif
+    ::operator delete(ptr, std::align_val_t{alignof(T)});
+  }
+
+  template <typename U>
+  void construct(U *ptr) noexcept(std::is_nothrow_default_constructible_v<U>) {
+    ::new (static_cast<void *>(ptr)) U;
+  }
+
+  template <typename U, typename... Args>
+  void construct(U *ptr, Args &&...args) {
+    ::new (static_cast<void *>(ptr)) U(std::forward<Args>(args)...);
+  }
+
+  // Pages faulted in by whoever writes them first
+  bool Lazy() const { return _lazy; }
+
+  template <typename U>
+  bool operator==(HugePageAllocator<U> const &) const {
+    return true;
+  }
+
+  HugePageAllocator() = default;
+
+  explicit HugePageAllocator(bool lazy) : _lazy(lazy) {}
+
+  template <typename U>
+  HugePageAllocator(HugePageAllocator<U> const &other)  // NOLINT
+      : _lazy(other.Lazy()) {}
+
+ private:
+  static size_t Rounded(size_t bytes) {
+    return (bytes + kHugePage - 1) & ~(kHugePage - 1);
+  }
+
+#ifdef __linux__
+  // Maps a huge page more than asked for and trims it down to an aligned
+  // block. MAP_POPULATE would fault the pages in before the advice, as small
+  // pages, so they are populated afterwards.
+  void *Map(size_t bytes) const {
+    void *mapped = mmap(nullptr, bytes + kHugePage, PROT_READ | PROT_WRITE,
+                        MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+    if (mapped == MAP_FAILED) {
+      throw std::bad_alloc{};
+    }
+    auto *raw = static_cast<char *>(mapped);
+    auto address = reinterpret_cast<uintptr_t>(raw);
+    auto *block = raw + ((kHugePage - address % kHugePage) % kHugePage);
+    if (block != raw) {
+      munmap(raw, static_cast<size_t>(block - raw));
+    }
+    if (auto tail = static_cast<size_t>(raw + kHugePage - block); tail > 0) {
+      munmap(block + bytes, tail);
+    }
+    madvise(block, bytes, MADV_HUGEPAGE);
+    if (!_lazy) {
+      Populate(block, bytes);
+    }
+    return block;
+  }
+
+  static void Populate(char *block, size_t bytes) {
+#ifdef MADV_POPULATE_WRITE
+    if (madvise(block, bytes, MADV_POPULATE_WRITE) == 0) {
+      return;
+    }
+#endif
+    auto page = static_cast<size_t>(sysconf(_SC_PAGESIZE));
+    for (size_t at = 0; at < bytes; at += page) {
+      static_cast<char volatile *>(block)[at] = 0;
+    }
+  }
+#endif
+
+  bool _lazy = false;
+};
+
+template <typename T>
+using HugePageVector = std::vector<T, HugePageAllocator<T>>;
+
+namespace ranges::detail {
+// Copy of alloc that leaves the pages to the first write, where it can
+template <typename Allocator>
+Allocator LazyAllocator(Allocator const &alloc) {
+  return alloc;
+}
+
+template <typename T>
+HugePageAllocator<T> LazyAllocator(HugePageAllocator<T> const &) {
+  return HugePageAllocator<T>{true};
+}
+}  // namespace ranges::detail
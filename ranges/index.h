@@ -0,0 +1,164 @@
+#pragma once
+#include <algorithm>
+#include <bit>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+#include "core.h"
+
+// SearchIndex
+
+// Read optimized lookup over a materialized range, keyed by a projection.
+// Elements are kept sorted by key, and the keys are laid out again in
+// Eytzinger order (the implicit tree of a heap: children of k at 2k and
+// 2k + 1). A search walks that tree without branching on the comparison and
+// prefetches the cache line that holds the descendants a line's worth of
+// keys further down (four levels for 4 byte keys), so the memory latency of
+// the deep levels overlaps. Find, Contains and Count dispatch to it through
+// find and count.
+
+template <typename Value, typename Proj = std::identity>
+class SearchIndex {
+ public:
+  using value_type = Value;
+  using key_type =
+      std::decay_t<std::invoke_result_t<Proj const &, Value const &>>;
+  using iterator = typename std::vector<Value>::const_iterator;
+  using const_iterator = iterator;
+
+  // Empty until built
+  explicit SearchIndex(Proj proj = {}) : _proj(std::move(proj)) {}
+
+  template <typename Range>  //
+  static SearchIndex Build(Range &&range, Proj proj) {
+    SearchIndex index{std::move(proj)};
+    auto &&sorted = index._sorted;
+    sorted.reserve(GetSizeHint(range).Reservation());
+    for (auto it = std::begin(range), end = std::end(range); it != end; ++it) {
+      sorted.emplace_back(*it);
+    }
+    std::stable_sort(sorted.begin(), sorted.end(),
+                     [&](Value const &lhs, Value const &rhs) {
+                       return index.Key(lhs) < index.Key(rhs);
+                     });
+    index._keys.resize(sorted.size() + 1);
+    index._ranks.resize(sorted.size() + 1);
+    size_t rank = 0;
+    index.Layout(rank, 1);
+    return index;
+  }
+
+  iterator begin() const  // NOLINT
+  {
+    return _sorted.begin();
+  }
+
+  iterator end() const  // NOLINT
+  {
+    return _sorted.end();
+  }
+
+  size_t size() const  // NOLINT
+  {
+    return _sorted.size();
+  }
+
+  // First element whose key is not less than key
+  iterator lower_bound(key_type const &key) const  // NOLINT
+  {
+    return _sorted.begin() + Search(key, std::less<>{});
+  }
+
+  // First element whose key is greater than key
+  iterator upper_bound(key_type const &key) const  // NOLINT
+  {
+    return _sorted.begin() + Search(key, std::less_equal<>{});
+  }
+
+  iterator find(key_type const &key) const  // NOLINT
+  {
+    auto it = lower_bound(key);
+    if (it == _sorted.end() || key < Key(*it)) {
+      return _sorted.end();
+    }
+    return it;
+  }
+
+  size_t count(key_type const &key) const  // NOLINT
+  {
+    return static_cast<size_t>(upper_bound(key) - lower_bound(key));
+  }
+
+  bool contains(key_type const &key) const  // NOLINT
+  {
+    return find(key) != _sorted.end();
+  }
+
+ private:
+  static constexpr size_t kLine = 64 / sizeof(key_type);
+
+  key_type Key(Value const &value) const {
+    return std::invoke(_proj, value);
+  }
+
+  // In order walk of the implicit tree hands out the sorted keys
+  void Layout(size_t &rank, size_t node) {
+    if (node >= _keys.size()) {
+      return;
+    }
+    Layout(rank, 2 * node);
+    _keys[node] = Key(_sorted[rank]);
+    _ranks[node] = static_cast<uint32_t>(rank++);
+    Layout(rank, 2 * node + 1);
+  }
+
+  // Rank of the first key for which go_right(key, probe) is false. Turning
+  // right appends a one bit to the node, the answer is the last left turn,
+  // found by stripping the trailing ones and the zero before them.
+  template <typename GoRight>
+  size_t Search(key_type const &key, GoRight go_right) const {
+    size_t size = _sorted.size();
+    auto base = reinterpret_cast<uintptr_t>(_keys.data());
+    size_t node = 1;
+    while (node <= size) {
+      __builtin_prefetch(reinterpret_cast<void const *>(
+          base + node * kLine * sizeof(key_type)));
+      node = 2 * node + static_cast<size_t>(go_right(_keys[node], key));
+    }
+    node >>= std::countr_one(node) + 1;
+    return node == 0 ? size : _ranks[node];
+  }
+
+  std::vector<Value> _sorted;
+  std::vector<key_type> _keys;
+  std::vector<uint32_t> _ranks;
+  [[no_unique_address]] Proj _proj;
+};
+
+namespace ranges {
+template <typename Proj = std::identity>
+struct Index {
+  template <typename Range>  //
+  auto operator()(Range &&range) {
+    return SearchIndex<GetValueType<Range>, Proj>::Build(range, _proj);
+  }
+
+  explicit Index(Proj &&p = {}) : _proj(std::move(p)) {}
+  explicit Index(Proj const &p) : _proj(p) {}
+
+ private:
+  Proj _proj;
+};
+template <typename Proj>
+Index(Proj &&) -> Index<std::decay_t<Proj>>;
+}  // namespace ranges
+
+template <typename Range, typename Proj = std::identity>  //
+inline auto Index(Range &&range, Proj &&proj = {}) {
+  return ranges::Index<std::decay_t<Proj>>(std::forward<Proj>(proj))(
+      std::forward<Range>(range));
+}
@@ -0,0 +1,126 @@
+#pragma once
+#include <functional>
+#include <utility>
+
+#include "core.h"
+
+// Map
+
+// Iterators may point back to the function held by their view (Functor
+// Storage in core.h) and must not outlive it.
+
+template <typename Range, typename UnaryOp>  //
+class MapView : private SizedView<Range>, private FunctorWrapper<UnaryOp> {
+  // How iterators over It hold the functor
+  template <typename It>  //
+  using IterFunctor = FunctorRef<UnaryOp, typename It::reference>;
+
+  template <typename Sent>  //
+  struct MapSentinel {
+    Sent end;
+  };
+
+  template <typename It>  //
+  struct MapIterator : private It, private IterFunctor<It> {
+    using iterator_category = std::forward_iterator_tag;
+
+    using reference =
+        std::invoke_result_t<FunctorWrapper<UnaryOp>, typename It::reference>;
+
+    using value_type = std::decay_t<reference>;
+    using pointer = value_type *;
+    using difference_type = typename It::difference_type;
+
+    MapIterator(FunctorWrapper<UnaryOp> &u, It i)
+        : It(i), IterFunctor<It>(u) {}
+
+    reference operator*() {
+      return IterFunctor<It>::operator()(It::operator*());
+    }
+
+    MapIterator &operator++() {
+      It::operator++();
+      return *this;
+    }
+
+    MapIterator operator++(int)  // NOLINT
+    {
+      auto tmp = *this;
+      ++*this;
+      return tmp;
+    }
+
+    bool operator==(const MapIterator &rhs) const {
+      return static_cast<It const &>(*this) == static_cast<It const &>(rhs);
+    }
+    bool operator!=(const MapIterator &rhs) const { return !(*this == rhs); }
+
+    template <typename Sent>  //
+    bool operator==(const MapSentinel<Sent> &rhs) const {
+      return static_cast<It const &>(*this) == rhs.end;
+    }
+    template <typename Sent>  //
+    bool operator!=(const MapSentinel<Sent> &rhs) const {
+      return !(*this == rhs);
+    }
+  };
+
+ public:
+  using iterator = MapIterator<GetIter<Range>>;
+  using sentinel = MapSentinel<GetSentinel<Range>>;
+
+  iterator begin()  // NOLINT
+  {
+    return {static_cast<FunctorWrapper<UnaryOp> &>(*this),
+            SizedView<Range>::begin()};
+  }
+
+  sentinel end()  // NOLINT
+  {
+    return {SizedView<Range>::end()};
+  }
+
+  using SizedView<Range>::size;
+  using SizedView<Range>::Hint;
+
+  using SizedView<Range>::Base;
+  FunctorWrapper<UnaryOp> &Functor() { return *this; }
+
+  template <typename U>
+  explicit MapView(Range &range, U &&op)
+      : SizedView<Range>(range),  //
+        FunctorWrapper<UnaryOp>(std::forward<U>(op)) {}
+};
+template <typename Rng, typename U>  //
+MapView(Rng &&c, U &&u) -> MapView<Rng, std::remove_reference_t<U>>;
+
+template <typename Range, typename UnaryOp>
+struct IsView<MapView<Range, UnaryOp>> : std::true_type {};
+template <typename Range, typename UnaryOp>
+struct IsSized<MapView<Range, UnaryOp>> : IsSized<Range> {};
+template <typename Range, typename UnaryOp>
+struct BorrowsView<MapView<Range, UnaryOp>>
+    : std::disjunction<
+          std::negation<IsInlineFunctor<UnaryOp, GetIterReference<Range>>>,
+          BorrowsView<std::decay_t<Range>>> {};
+
+namespace ranges {
+template <typename UnaryOp>
+struct Map : private FunctorWrapper<UnaryOp> {
+  template <typename Range>  //
+  auto operator()(Range &&input_range) {
+    return MapView{input_range, Functor()};
+  }
+
+  FunctorWrapper<UnaryOp> &Functor() { return *this; }
+
+  explicit Map(UnaryOp &&o) : FunctorWrapper<UnaryOp>(std::move(o)) {}
+  explicit Map(UnaryOp const &o) : FunctorWrapper<UnaryOp>(o) {}
+};
+}  // namespace ranges
+
+template <typename Range, typename UnaryOp>  //
+inline auto Map(Range &&input_range, UnaryOp &&op) {
+  return ranges::Map(std::forward<UnaryOp>(op))(
+      std::forward<Range>(input_range));
+}
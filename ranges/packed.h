@@ -0,0 +1,242 @@
+#pragma once
+#include <algorithm>
+#include <array>
+#include <bit>
+#include <cstddef>
+#include <cstdint>
+#include <limits>
+#include <type_traits>
+#include <vector>
+
+#include "core.h"
+
+// PackedColumn
+
+// Compressed integer column. Every block of 128 elements is stored either as
+// offsets from the block minimum (frame of reference) or, for non decreasing
+// blocks where it is narrower, as deltas between neighbours, bit packed to
+// the widest offset or delta of the block. Iteration decodes a whole block at
+// a time into a buffer held by the iterator, so elements are returned by
+// value and an iterator copy carries the decoded block: advance one iterator
+// rather than copying it per element.
+
+template <typename T>
+class PackedColumn {
+  static_assert(std::is_integral_v<T>, "PackedColumn stores integers only");
+
+  using U = std::make_unsigned_t<T>;
+
+  static constexpr size_t kBlock = 128;
+  static constexpr size_t kBits = 64;
+
+  struct Block {
+    U base;
+    uint32_t offset;
+    uint8_t width;
+    bool delta;
+  };
+
+  struct PackedSentinel {
+    size_t size;
+  };
+
+  // A block of width W takes exactly 2 * W words, once the loop over 64
+  // values is unrolled every shift is a constant
+  template <size_t Width>  //
+  static void Unpack(uint64_t const *words, U *out, U base) {
+    constexpr uint64_t mask =
+        Width == kBits ? ~uint64_t{0} : (uint64_t{1} << Width) - 1;
+    for (size_t half = 0; half < 2; ++half, words += Width, out += kBits) {
+#pragma GCC unroll 64
+      for (size_t i = 0; i < kBits; ++i) {
+        size_t bit = i * Width;
+        size_t shift = bit % kBits;
+        uint64_t value = words[bit / kBits] >> shift;
+        if (shift + Width > kBits) {
+          value |= words[bit / kBits + 1] << (kBits - shift);
+        }
+        out[i] = static_cast<U>(static_cast<U>(value & mask) + base);
+      }
+    }
+  }
+
+  using Unpacker = void (*)(uint64_t const *, U *, U);
+
+  template <size_t... Widths>  //
+  static constexpr std::array<Unpacker, sizeof...(Widths)> Unpackers(
+      std::index_sequence<Widths...>) {
+    return {&Unpack<Widths>...};
+  }
+
+  static constexpr auto kUnpackers =
+      Unpackers(std::make_index_sequence<std::numeric_limits<U>::digits + 1>{});
+
+  struct PackedIterator {
+    using iterator_category = std::forward_iterator_tag;
+    using value_type = T;
+    using difference_type = std::ptrdiff_t;
+    using reference = T;
+    using pointer = T const *;
+
+    reference operator*() const { return buffer[index % kBlock]; }
+
+    PackedIterator &operator++() {
+      if (++index % kBlock == 0 && index < column->_size) {
+        column->Decode(index / kBlock, buffer.data());
+      }
+      return *this;
+    }
+
+    PackedIterator operator++(int)  // NOLINT
+    {
+      auto tmp = *this;
+      ++*this;
+      return tmp;
+    }
+
+    bool operator==(const PackedIterator &rhs) const {
+      return index == rhs.index;
+    }
+    bool operator!=(const PackedIterator &rhs) const { return !(*this == rhs); }
+
+    bool operator==(const PackedSentinel &rhs) const {
+      return index == rhs.size;
+    }
+    bool operator!=(const PackedSentinel &rhs) const { return !(*this == rhs); }
+
+    friend difference_type operator-(const PackedSentinel &lhs,
+                                     const PackedIterator &rhs) {
+      return static_cast<difference_type>(lhs.size - rhs.index);
+    }
+
+    PackedIterator(PackedColumn const *c, size_t i) : column(c), index(i) {
+      if (index < column->_size) {
+        column->Decode(index / kBlock, buffer.data());
+      }
+    }
+
+    PackedColumn const *column;
+    size_t index;
+    std::array<T, kBlock> buffer;
+  };
+
+ public:
+  using iterator = PackedIterator;
+  using const_iterator = PackedIterator;
+  using sentinel = PackedSentinel;
+  using value_type = T;
+
+  template <typename Range>  //
+  static PackedColumn Encode(Range &&range) {
+    PackedColumn column;
+    std::array<U, kBlock> values;
+    size_t count = 0;
+    for (auto it = std::begin(range), end = std::end(range); it != end; ++it) {
+      values[count++] = static_cast<U>(static_cast<T>(*it));
+      if (count == kBlock) {
+        column.Append(values.data(), count);
+        count = 0;
+      }
+    }
+    if (count != 0) {
+      column.Append(values.data(), count);
+    }
+    column._words.shrink_to_fit();
+    column._blocks.shrink_to_fit();
+    return column;
+  }
+
+  iterator begin() const  // NOLINT
+  {
+    return {this, 0};
+  }
+
+  sentinel end() const  // NOLINT
+  {
+    return {_size};
+  }
+
+  size_t size() const  // NOLINT
+  {
+    return _size;
+  }
+
+  // Encoded footprint
+  size_t Bytes() const {
+    return _words.size() * sizeof(uint64_t) + _blocks.size() * sizeof(Block);
+  }
+
+  // Decodes a block into out, which has room for a whole block even when the
+  // last one is partial
+  void Decode(size_t block, T *out) const {
+    auto &&header = _blocks[block];
+    size_t count = std::min(kBlock, _size - block * kBlock);
+    if (header.width == 0) {
+      std::fill_n(out, count, static_cast<T>(header.base));
+      return;
+    }
+    auto *values = reinterpret_cast<U *>(out);
+    kUnpackers[header.width](_words.data() + header.offset, values,
+                             header.delta ? U{0} : header.base);
+    if (header.delta) {
+      U value = header.base;
+      for (size_t i = 0; i < count; ++i) {
+        values[i] = value += values[i];
+      }
+    }
+  }
+
+ private:
+  void Append(U *values, size_t count) {
+    T min = static_cast<T>(values[0]);
+    T max = min;
+    U widest_delta = 0;
+    bool sorted = true;
+    for (size_t i = 1; i < count; ++i) {
+      auto value = static_cast<T>(values[i]);
+      min = std::min(min, value);
+      max = std::max(max, value);
+      sorted = sorted && static_cast<T>(values[i - 1]) <= value;
+      widest_delta |= static_cast<U>(values[i] - values[i - 1]);
+    }
+    auto reference_width = std::bit_width(
+        static_cast<U>(static_cast<U>(max) - static_cast<U>(min)));
+    auto delta_width = std::bit_width(widest_delta);
+
+    Block header{static_cast<U>(min), static_cast<uint32_t>(_words.size()),
+                 static_cast<uint8_t>(reference_width), false};
+    if (sorted && delta_width < reference_width) {
+      header = {values[0], header.offset, static_cast<uint8_t>(delta_width),
+                true};
+      for (size_t i = count - 1; i > 0; --i) {
+        values[i] = static_cast<U>(values[i] - values[i - 1]);
+      }
+      values[0] = 0;
+    } else {
+      for (size_t i = 0; i < count; ++i) {
+        values[i] = static_cast<U>(values[i] - header.base);
+      }
+    }
+    assert(_words.size() <= std::numeric_limits<uint32_t>::max());
+
+    // A partial block is padded, decoding always unpacks whole blocks
+    _words.resize(_words.size() + 2 * header.width);
+    uint64_t *words = _words.data() + header.offset;
+    for (size_t i = 0; i < count && header.width != 0; ++i) {
+      size_t bit = i * header.width;
+      size_t shift = bit % kBits;
+      words[bit / kBits] |= static_cast<uint64_t>(values[i]) << shift;
+      if (shift + header.width > kBits) {
+        words[bit / kBits + 1] |= static_cast<uint64_t>(values[i]) >>
+                                  (kBits - shift);
+      }
+    }
+    _blocks.push_back(header);
+    _size += count;
+  }
+
+  std::vector<uint64_t> _words;
+  std::vector<Block> _blocks;
+  size_t _size = 0;
+};
+
@@ -0,0 +1,261 @@
+#pragma once
+#include <algorithm>
+#include <condition_variable>
+#include <cstddef>
+#include <exception>
+#include <functional>
+#include <mutex>
+#include <optional>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+#include "core.h"
+#include "huge_pages.h"
+#include "scan.h"
+#include "terminals.h"
+#include "thread_pool.h"
+
+// Parallel Terminals
+
+// Terminals taking ranges::Parallel first split a random access source into
+// one chunk per worker and combine the chunk results in order, so they agree
+// with the sequential ones. Other sources, and sources shorter than the
+// grain, run sequentially. They block the caller, so must not be called from
+// a worker of the same pool.
+
+namespace ranges {
+struct Parallel {
+  ThreadPool &pool;
+  size_t grain = size_t{1} << 14;
+};
+}  // namespace ranges
+
+namespace ranges::detail {
+template <typename It>
+struct Chunk {
+  It begin() const { return first; }  // NOLINT
+  It end() const { return last; }     // NOLINT
+
+  It first;
+  It last;
+};
+
+// Runs func(0) .. func(chunks - 1), the caller takes the first chunk. The
+// tasks refer to this frame, so it waits for all of them even when a chunk
+// throws, and rethrows the first exception afterwards.
+template <typename Func>
+void RunChunks(ThreadPool &pool, size_t chunks, Func &func) {
+  std::mutex mutex;
+  std::condition_variable done;
+  size_t left = chunks - 1;
+  std::exception_ptr error;
+  auto fail = [&] {
+    std::lock_guard lock{mutex};
+    if (!error) {
+      error = std::current_exception();
+    }
+  };
+  size_t posted = 1;
+  try {
+    for (; posted < chunks; ++posted) {
+      pool.Post([&, chunk = posted] {
+        try {
+          func(chunk);
+        } catch (...) {
+          fail();
+        }
+        std::lock_guard lock{mutex};
+        if (--left == 0) {
+          done.notify_one();
+        }
+      });
+    }
+    func(0);
+  } catch (...) {
+    fail();
+    std::lock_guard lock{mutex};
+    left -= chunks - posted;
+  }
+  std::unique_lock lock{mutex};
+  done.wait(lock, [&] { return left == 0; });
+  if (error) {
+    std::rethrow_exception(error);
+  }
+}
+
+// Chunk of a random access range split into chunks of about equal size
+template <typename Range>
+Chunk<GetIter<Range>> ChunkOf(Range &range, size_t chunks, size_t chunk) {
+  auto begin = std::begin(range);
+  auto size = static_cast<size_t>(std::end(range) - begin);
+  return {begin + static_cast<std::ptrdiff_t>(size * chunk / chunks),
+          begin + static_cast<std::ptrdiff_t>(size * (chunk + 1) / chunks)};
+}
+
+// Results of terminal over every chunk of range, in order. Empty when the
+// range is not worth splitting.
+template <typename Range, typename Terminal,
+          typename Result = std::invoke_result_t<Terminal &,
+                                                 Chunk<GetIter<Range>> &>>
+std::vector<Result> MapChunks(Parallel policy, Range &range,
+                              Terminal terminal) {
+  if constexpr (!IsRandomAccess<Range>::value) {
+    return {};
+  } else {
+    auto begin = std::begin(range);
+    auto size = static_cast<size_t>(std::end(range) - begin);
+    size_t chunks = std::min(policy.pool.size() + 1, size / policy.grain);
+    if (chunks < 2) {
+      return {};
+    }
+    std::vector<std::optional<Result>> results(chunks);
+    auto run = [&](size_t chunk) {
+      auto part = ChunkOf(range, chunks, chunk);
+      results[chunk].emplace(terminal(part));
+    };
+    RunChunks(policy.pool, chunks, run);
+    std::vector<Result> output;
+    output.reserve(chunks);
+    for (auto &&result : results) {
+      output.push_back(*std::move(result));
+    }
+    return output;
+  }
+}
+}  // namespace ranges::detail
+
+template <typename Range, typename Cmp = std::less<>,
+          typename Proj = std::identity>
+inline GetValueType<Range> Max(ranges::Parallel policy, Range &&range,
+                               Cmp cmp = {}, Proj proj = {}) {
+  auto maxima = ranges::detail::MapChunks(
+      policy, range, [&](auto &part) { return Max(part, cmp, proj); });
+  if (maxima.empty()) {
+    return Max(range, cmp, proj);
+  }
+  return Max(View{maxima}, cmp, proj);
+}
+
+template <typename Range, typename Cmp = std::less<>,
+          typename Proj = std::identity>
+inline GetValueType<Range> Min(ranges::Parallel policy, Range &&range,
+                               Cmp cmp = {}, Proj proj = {}) {
+  auto minima = ranges::detail::MapChunks(
+      policy, range, [&](auto &part) { return Min(part, cmp, proj); });
+  if (minima.empty()) {
+    return Min(range, cmp, proj);
+  }
+  return Min(View{minima}, cmp, proj);
+}
+
+template <typename Range, typename Cmp = std::less<>,
+          typename Proj = std::identity>
+inline std::pair<GetValueType<Range>, GetValueType<Range>> MinMax(
+    ranges::Parallel policy, Range &&range, Cmp cmp = {}, Proj proj = {}) {
+  auto extrema = ranges::detail::MapChunks(
+      policy, range, [&](auto &part) { return MinMax(part, cmp, proj); });
+  if (extrema.empty()) {
+    return MinMax(range, cmp, proj);
+  }
+  return {Min(View{extrema} | ranges::Map([](auto &&e) { return e.first; }),
+              cmp, proj),
+          Max(View{extrema} | ranges::Map([](auto &&e) { return e.second; }),
+              cmp, proj)};
+}
+
+template <typename Range, typename Cmp = std::less<>,
+          typename Proj = std::identity>
+inline GetIter<Range> ArgMax(ranges::Parallel policy, Range &&range,
+                             Cmp cmp = {}, Proj proj = {}) {
+  static_assert(ranges::detail::CanReturnIterator<Range>::value,
+                "the iterator would point into a temporary view");
+  auto maxima = ranges::detail::MapChunks(
+      policy, range, [&](auto &part) { return ArgMax(part, cmp, proj); });
+  if (maxima.empty()) {
+    return ArgMax(range, cmp, proj);
+  }
+  return *ArgMax(View{maxima}, cmp,
+                 [&](auto &&it) { return std::invoke(proj, *it); });
+}
+
+template <typename Range, typename Cmp = std::less<>,
+          typename Proj = std::identity>
+inline GetIter<Range> ArgMin(ranges::Parallel policy, Range &&range,
+                             Cmp cmp = {}, Proj proj = {}) {
+  static_assert(ranges::detail::CanReturnIterator<Range>::value,
+                "the iterator would point into a temporary view");
+  auto minima = ranges::detail::MapChunks(
+      policy, range, [&](auto &part) { return ArgMin(part, cmp, proj); });
+  if (minima.empty()) {
+    return ArgMin(range, cmp, proj);
+  }
+  return *ArgMin(View{minima}, cmp,
+                 [&](auto &&it) { return std::invoke(proj, *it); });
+}
+
+// Eager inclusive scan into a vector, in two passes over the source: the
+// chunk totals first, then every chunk is scanned from the aggregate of the
+// chunks before it. op must be associative, floating point sums may differ
+// from the sequential ones in the last bits. Like the sequential Scan, init
+// is folded in once, in front of the first element.
+template <typename Range, typename BinOp, typename T>
+inline std::vector<T> Scan(ranges::Parallel policy, Range &&range, BinOp op,
+                           T init) {
+  auto totals =
+      ranges::detail::MapChunks(policy, range, [&](auto &part) -> T {
+        auto it = part.begin();
+        return Fold(ranges::detail::Chunk<decltype(it)>{std::next(it),
+                                                        part.end()},
+                    T(*it), op);
+      });
+  if (totals.empty()) {
+    return Scan(range, op, std::move(init)) | ranges::Collect<std::vector<T>>{};
+  }
+  std::vector<T> offsets;
+  offsets.reserve(totals.size());
+  for (auto &&total : totals) {
+    offsets.push_back(init);
+    init = std::invoke(op, std::move(init), std::move(total));
+  }
+  std::vector<T> output(static_cast<size_t>(std::end(range) -
+                                            std::begin(range)));
+  auto run = [&](size_t chunk) {
+    auto part = ranges::detail::ChunkOf(range, offsets.size(), chunk);
+    auto out = output.begin() + (part.first - std::begin(range));
+    auto acc = std::move(offsets[chunk]);
+    for (auto it = part.first; it != part.last; ++it, ++out) {
+      acc = std::invoke(op, std::move(acc), *it);
+      *out = acc;
+    }
+  };
+  ranges::detail::RunChunks(policy.pool, offsets.size(), run);
+  return output;
+}
+
+// Eager Collect into a std::vector, every chunk copied by its own worker.
+// With a HugePageAllocator the output pages are left unfaulted and first
+// touched by the thread writing them; other allocators value initialize the
+// whole output in the caller first.
+template <typename OutputRange, typename Range>
+inline OutputRange Collect(ranges::Parallel policy, Range &&range) {
+  if constexpr (!IsRandomAccess<Range>::value) {
+    return ranges::Collect<OutputRange>{}(range);
+  } else {
+    auto begin = std::begin(range);
+    auto size = static_cast<size_t>(std::end(range) - begin);
+    size_t chunks = std::min(policy.pool.size() + 1, size / policy.grain);
+    if (chunks < 2) {
+      return ranges::Collect<OutputRange>{}(range);
+    }
+    OutputRange output(ranges::detail::LazyAllocator(
+        typename OutputRange::allocator_type{}));
+    output.resize(size);
+    auto run = [&](size_t chunk) {
+      auto part = ranges::detail::ChunkOf(range, chunks, chunk);
+      std::copy(part.first, part.last, output.begin() + (part.first - begin));
+    };
+    ranges::detail::RunChunks(policy.pool, chunks, run);
+    return output;
+  }
+}
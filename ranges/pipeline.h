@@ -0,0 +1,213 @@
+#pragma once
+#include <algorithm>
+#include <optional>
+#include <type_traits>
+#include <utility>
+
+#include "core.h"
+#include "filter.h"
+#include "filter_map.h"
+#include "map.h"
+#include "take.h"
+
+// Pipeline Rewriting
+
+// operator| fuses adjacent stages into a single view at compile time:
+//   Filter | Filter    -> Filter of the conjunction
+//   Map | Map          -> Map of the composition
+//   Filter | Map       -> FilterMap
+//   Map | Filter       -> FilterMap
+//   FilterMap | Map    -> FilterMap
+//   FilterMap | Filter -> FilterMap
+//   Take(a) | Take(b)  -> Take(min(a, b))
+// Maps returning references are left alone, FilterMap holds its elements by
+// value.
+//
+// Only the Filter, Map and Take pairs of the same kind behave exactly like
+// the separate stages. A fused FilterMap calls the map while advancing, once
+// per element that gets past the filters, instead of on every dereference:
+// elements that are only counted (Len, the size of Take) or stepped over
+// still run the map, and a Map | Filter no longer runs it twice for kept
+// elements. Expensive or side-effecting maps should not count on when or how
+// often they run.
+
+namespace ranges::detail {
+template <typename F, typename G>
+struct Composed {
+  template <typename T>  //
+  decltype(auto) operator()(T &&elem) {
+    return second(first(std::forward<T>(elem)));
+  }
+
+  [[no_unique_address]] FunctorWrapper<F> first;
+  [[no_unique_address]] FunctorWrapper<G> second;
+};
+template <typename F, typename G>
+Composed(FunctorWrapper<F>, FunctorWrapper<G>) -> Composed<F, G>;
+
+template <typename P, typename Q>
+struct Conjunction {
+  template <typename T>  //
+  bool operator()(T &&elem) {
+    return first(elem) && second(elem);
+  }
+
+  [[no_unique_address]] FunctorWrapper<P> first;
+  [[no_unique_address]] FunctorWrapper<Q> second;
+};
+template <typename P, typename Q>
+Conjunction(FunctorWrapper<P>, FunctorWrapper<Q>) -> Conjunction<P, Q>;
+
+template <typename P, typename F>
+struct FilterThenMap {
+  template <typename T>  //
+  auto operator()(T &&elem) -> std::optional<
+      std::decay_t<std::invoke_result_t<FunctorWrapper<F> &, T>>> {
+    if (pred(elem)) {
+      return func(std::forward<T>(elem));
+    }
+    return std::nullopt;
+  }
+
+  [[no_unique_address]] FunctorWrapper<P> pred;
+  [[no_unique_address]] FunctorWrapper<F> func;
+};
+template <typename P, typename F>
+FilterThenMap(FunctorWrapper<P>, FunctorWrapper<F>) -> FilterThenMap<P, F>;
+
+template <typename F, typename P>
+struct MapThenFilter {
+  template <typename T>  //
+  auto operator()(T &&elem) -> std::optional<
+      std::decay_t<std::invoke_result_t<FunctorWrapper<F> &, T>>> {
+    auto &&value = func(std::forward<T>(elem));
+    if (pred(value)) {
+      return std::move(value);
+    }
+    return std::nullopt;
+  }
+
+  [[no_unique_address]] FunctorWrapper<F> func;
+  [[no_unique_address]] FunctorWrapper<P> pred;
+};
+template <typename F, typename P>
+MapThenFilter(FunctorWrapper<F>, FunctorWrapper<P>) -> MapThenFilter<F, P>;
+
+template <typename FM, typename F>
+struct FilterMapThenMap {
+  template <typename T>  //
+  auto operator()(T &&elem) {
+    auto value = filter_map(std::forward<T>(elem));
+    using Result = std::decay_t<decltype(func(*std::move(value)))>;
+    if (value.has_value()) {
+      return std::optional<Result>{func(*std::move(value))};
+    }
+    return std::optional<Result>{};
+  }
+
+  [[no_unique_address]] FunctorWrapper<FM> filter_map;
+  [[no_unique_address]] FunctorWrapper<F> func;
+};
+template <typename FM, typename F>
+FilterMapThenMap(FunctorWrapper<FM>, FunctorWrapper<F>)
+    -> FilterMapThenMap<FM, F>;
+
+template <typename FM, typename P>
+struct FilterMapThenFilter {
+  template <typename T>  //
+  auto operator()(T &&elem) {
+    auto value = filter_map(std::forward<T>(elem));
+    if (value.has_value() && !pred(*value)) {
+      value.reset();
+    }
+    return value;
+  }
+
+  [[no_unique_address]] FunctorWrapper<FM> filter_map;
+  [[no_unique_address]] FunctorWrapper<P> pred;
+};
+template <typename FM, typename P>
+FilterMapThenFilter(FunctorWrapper<FM>, FunctorWrapper<P>)
+    -> FilterMapThenFilter<FM, P>;
+
+template <typename>
+struct IsMapView : std::false_type {};
+template <typename Range, typename UnaryOp>
+struct IsMapView<MapView<Range, UnaryOp>> : std::true_type {};
+
+template <typename>
+struct IsFilterView : std::false_type {};
+template <typename Range, typename Pred>
+struct IsFilterView<FilterView<Range, Pred>> : std::true_type {};
+
+template <typename>
+struct IsFilterMapView : std::false_type {};
+template <typename Range, typename Func>
+struct IsFilterMapView<FilterMapView<Range, Func>> : std::true_type {};
+
+template <typename>
+struct IsTakeView : std::false_type {};
+template <typename Range>
+struct IsTakeView<TakeView<Range>> : std::true_type {};
+
+template <typename>
+struct IsMapStage : std::false_type {};
+template <typename UnaryOp>
+struct IsMapStage<ranges::Map<UnaryOp>> : std::true_type {};
+
+template <typename>
+struct IsFilterStage : std::false_type {};
+template <typename Pred>
+struct IsFilterStage<ranges::Filter<Pred>> : std::true_type {};
+
+// A Map stage applied to the elements of Range yields prvalues
+template <typename Range, typename Comb, typename = void>
+struct MapsToValues : std::false_type {};
+template <typename Range, typename UnaryOp>
+struct MapsToValues<Range, ranges::Map<UnaryOp>>
+    : std::negation<std::is_reference<std::invoke_result_t<
+          FunctorWrapper<UnaryOp> &, GetIterReference<Range>>>> {};
+}  // namespace ranges::detail
+
+template <typename Range, typename Comb,
+          typename = std::enable_if_t<IsView<Range>::value>>
+inline auto operator|(Range &&rng, Comb comb) {
+  namespace detail = ranges::detail;
+  using Upstream = std::remove_reference_t<Range>;
+
+  if constexpr (std::is_const_v<Upstream>) {
+    return comb(std::forward<Range>(rng));
+  } else if constexpr (detail::IsFilterView<Upstream>::value &&
+                       detail::IsFilterStage<Comb>::value) {
+    return FilterView{rng.Base(), detail::Conjunction{rng.Functor(),  //
+                                                      comb.Functor()}};
+  } else if constexpr (detail::IsMapView<Upstream>::value &&
+                       detail::IsMapStage<Comb>::value) {
+    return MapView{rng.Base(), detail::Composed{rng.Functor(),  //
+                                                comb.Functor()}};
+  } else if constexpr (detail::IsFilterView<Upstream>::value &&
+                       detail::MapsToValues<Upstream, Comb>::value) {
+    return FilterMapView{rng.Base(), detail::FilterThenMap{rng.Functor(),  //
+                                                           comb.Functor()}};
+  } else if constexpr (detail::IsMapView<Upstream>::value &&
+                       detail::IsFilterStage<Comb>::value &&
+                       !std::is_reference_v<GetIterReference<Upstream>>) {
+    return FilterMapView{rng.Base(), detail::MapThenFilter{rng.Functor(),  //
+                                                           comb.Functor()}};
+  } else if constexpr (detail::IsFilterMapView<Upstream>::value &&
+                       detail::MapsToValues<Upstream, Comb>::value) {
+    return FilterMapView{rng.Base(),
+                         detail::FilterMapThenMap{rng.Functor(),  //
+                                                  comb.Functor()}};
+  } else if constexpr (detail::IsFilterMapView<Upstream>::value &&
+                       detail::IsFilterStage<Comb>::value) {
+    return FilterMapView{rng.Base(),
+                         detail::FilterMapThenFilter{rng.Functor(),  //
+                                                     comb.Functor()}};
+  } else if constexpr (detail::IsTakeView<Upstream>::value &&
+                       std::is_same_v<Comb, ranges::Take>) {
+    return TakeView{rng.Base(), std::min(rng.Count(), comb._count)};
+  } else {
+    return comb(std::forward<Range>(rng));
+  }
+}
@@ -0,0 +1,174 @@
+#pragma once
+#include <cstddef>
+#include <iterator>
+#include <memory>
+#include <type_traits>
+#include <utility>
+
+#include "core.h"
+
+// Prefetch
+
+// Issues software prefetches a fixed number of elements ahead of the
+// consumer. By default the element itself is prefetched, for pointer chasing
+// data a projection picks the address that is going to be loaded (vectors
+// of pointers or indices). Only random access sources are prefetched: on
+// linked sources (std::list, std::map) reaching the node ahead chases the
+// same next pointers serially, which doubles the dependent loads instead of
+// hiding them, so the view passes them through unchanged.
+
+namespace ranges::detail {
+struct ElementAddress {
+  template <typename T>  //
+  void const *operator()(T &&elem) const {
+    if constexpr (std::is_lvalue_reference_v<T &&>) {
+      return std::addressof(elem);
+    } else {
+      return nullptr;
+    }
+  }
+};
+}  // namespace ranges::detail
+
+template <typename Range, typename Proj>
+class PrefetchView : private SizedView<Range>, private FunctorWrapper<Proj> {
+  // How iterators over It hold the functor
+  template <typename It>  //
+  using IterFunctor = FunctorRef<Proj, typename It::reference>;
+
+  template <typename Sent>  //
+  struct PrefetchSentinel {
+    Sent end;
+  };
+
+  template <typename It, typename Sent>  //
+  struct PrefetchIterator : private IterFunctor<It> {
+    using iterator_category = std::forward_iterator_tag;
+    using value_type = typename It::value_type;
+    using difference_type = typename It::difference_type;
+    using reference = typename It::reference;
+    using pointer = typename It::pointer;
+
+    static constexpr bool kAhead = std::is_same_v<
+        typename std::iterator_traits<It>::iterator_category,
+        std::random_access_iterator_tag>;
+
+    PrefetchIterator(FunctorWrapper<Proj> &p, It i, Sent e, size_t distance)
+        : IterFunctor<It>(p), it(i), ahead(i), end(e) {
+      if constexpr (kAhead) {
+        for (size_t step = 0; step < distance && ahead != end; ++step) {
+          Touch();
+        }
+      }
+    }
+
+    reference operator*() { return *it; }
+
+    PrefetchIterator &operator++() {
+      ++it;
+      if constexpr (kAhead) {
+        if (ahead != end) {
+          Touch();
+        }
+      }
+      return *this;
+    }
+
+    PrefetchIterator operator++(int)  // NOLINT
+    {
+      auto tmp = *this;
+      ++*this;
+      return tmp;
+    }
+
+    bool operator==(const PrefetchIterator &rhs) const { return it == rhs.it; }
+    bool operator!=(const PrefetchIterator &rhs) const {
+      return !(*this == rhs);
+    }
+
+    bool operator==(const PrefetchSentinel<Sent> &rhs) const {
+      return it == rhs.end;
+    }
+    bool operator!=(const PrefetchSentinel<Sent> &rhs) const {
+      return !(*this == rhs);
+    }
+
+    void Touch() {
+      if (auto &&address = IterFunctor<It>::operator()(*ahead)) {
+        __builtin_prefetch(std::to_address(address));
+      }
+      ++ahead;
+    }
+
+    It it;
+    It ahead;
+    Sent end;
+  };
+
+ public:
+  using iterator = PrefetchIterator<GetIter<Range>, GetSentinel<Range>>;
+  using sentinel = PrefetchSentinel<GetSentinel<Range>>;
+
+  iterator begin()  // NOLINT
+  {
+    return {static_cast<FunctorWrapper<Proj> &>(*this),
+            SizedView<Range>::begin(), SizedView<Range>::end(), _distance};
+  }
+
+  sentinel end()  // NOLINT
+  {
+    return {SizedView<Range>::end()};
+  }
+
+  using SizedView<Range>::size;
+  using SizedView<Range>::Hint;
+
+  template <typename P>
+  explicit PrefetchView(Range &range, size_t distance, P &&proj)
+      : SizedView<Range>(range),  //
+        FunctorWrapper<Proj>(std::forward<P>(proj)),
+        _distance(distance) {}
+
+ private:
+  size_t _distance;
+};
+template <typename Rng, typename Proj>  //
+PrefetchView(Rng &&c, size_t, Proj &&p)
+    -> PrefetchView<Rng, std::remove_reference_t<Proj>>;
+
+template <typename Range, typename Proj>
+struct IsView<PrefetchView<Range, Proj>> : std::true_type {};
+template <typename Range, typename Proj>
+struct IsSized<PrefetchView<Range, Proj>> : IsSized<Range> {};
+template <typename Range, typename Proj>
+struct BorrowsView<PrefetchView<Range, Proj>>
+    : std::disjunction<
+          std::negation<IsInlineFunctor<Proj, GetIterReference<Range>>>,
+          BorrowsView<std::decay_t<Range>>> {};
+
+namespace ranges {
+template <typename Proj = detail::ElementAddress>
+struct Prefetch : private FunctorWrapper<Proj> {
+  template <typename Range>  //
+  auto operator()(Range &&range) {
+    return PrefetchView{range, _distance,
+                        static_cast<FunctorWrapper<Proj> &>(*this)};
+  }
+
+  explicit Prefetch(size_t distance, Proj &&p = {})
+      : FunctorWrapper<Proj>(std::move(p)), _distance(distance) {}
+  explicit Prefetch(size_t distance, Proj const &p)
+      : FunctorWrapper<Proj>(p), _distance(distance) {}
+
+  size_t _distance;
+};
+template <typename Proj>
+Prefetch(size_t, Proj &&) -> Prefetch<std::decay_t<Proj>>;
+Prefetch(size_t) -> Prefetch<>;
+}  // namespace ranges
+
+template <typename Range, typename Proj = ranges::detail::ElementAddress>  //
+inline auto Prefetch(Range &&range, size_t distance, Proj &&proj = {}) {
+  return ranges::Prefetch(distance, std::forward<Proj>(proj))(
+      std::forward<Range>(range));
+}
@@ -0,0 +1,127 @@
+#pragma once
+#include <cstddef>
+#include <optional>
+
+#include "core.h"
+
+// RepeatView
+
+template <typename Range>
+class RepeatView : private SizedView<Range> {
+  // The iterator is exhausted once no passes are left, with a cut it stops
+  // earlier at the cut position of the last pass
+  template <typename It>  //
+  struct RepeatSentinel {
+    std::optional<It> cut;
+  };
+
+  template <typename It, typename Sent>
+  struct RepeatIterator {
+    using iterator_category = std::forward_iterator_tag;
+    using value_type = typename It::value_type;
+    using difference_type = typename It::difference_type;
+    using reference = typename It::reference;
+    using pointer = typename It::pointer;
+
+    reference operator*() { return *it; }
+
+    RepeatIterator &operator++() {
+      ++it;
+      if (it == end && --left > 0) {
+        it = begin;
+      }
+      return *this;
+    }
+
+    RepeatIterator operator++(int)  // NOLINT
+    {
+      auto tmp = *this;
+      ++*this;
+      return tmp;
+    }
+
+    bool operator==(const RepeatIterator &rhs) const {
+      return left == rhs.left && it == rhs.it;
+    }
+    bool operator!=(const RepeatIterator &rhs) const { return !(*this == rhs); }
+
+    bool operator==(const RepeatSentinel<It> &rhs) const {
+      return left == 0 || (rhs.cut.has_value() && left == 1 && it == *rhs.cut);
+    }
+    bool operator!=(const RepeatSentinel<It> &rhs) const {
+      return !(*this == rhs);
+    }
+
+    It it;
+    It begin;
+    Sent end;
+    int left;
+  };
+
+ public:
+  using iterator = RepeatIterator<GetIter<Range>, GetSentinel<Range>>;
+  using sentinel = RepeatSentinel<GetIter<Range>>;
+
+  iterator begin()  // NOLINT
+  {
+    auto &&bgn = SizedView<Range>::begin();
+    auto &&end = SizedView<Range>::end();
+    int count = bgn == end ? 0 : static_cast<int>(_count);
+
+    return {_cut.value_or(bgn), bgn, end, count};
+  }
+
+  sentinel end()  // NOLINT
+  {
+    return {_cut};
+  }
+
+  typename iterator::difference_type size() const  // NOLINT
+  {
+    return ranges::detail::SizeOf(*this);
+  }
+
+  // A cut pass starts and ends at the cut, together one full pass less. No
+  // passes are no elements, with or without a cut.
+  SizeHint Hint() const {
+    if (_count == 0) {
+      return SizeHint::Exactly(0);
+    }
+    return SizedView<Range>::Hint() * (_count - (_cut.has_value() ? 1 : 0));
+  }
+
+  explicit RepeatView(Range &range, size_t count,
+                      std::optional<GetIter<Range>> cut = std::nullopt)
+      : SizedView<Range>(range), _count(count), _cut(cut) {}
+
+ private:
+  size_t _count;
+  std::optional<GetIter<Range>> _cut;
+};
+
+template <typename Rng>  //
+RepeatView(Rng &&c) -> RepeatView<Rng>;
+
+template <typename Range>
+struct IsView<RepeatView<Range>> : std::true_type {};
+template <typename Range>
+struct IsSized<RepeatView<Range>> : IsSized<Range> {};
+
+namespace ranges {
+struct Repeat {
+  template <typename Range>  //
+  auto operator()(Range &&range) {
+    return RepeatView{range, count};
+  }
+
+  explicit Repeat(size_t c) : count(c) {}
+
+  size_t count;
+};
+}  // namespace ranges
+
+template <typename Range>  //
+inline auto Repeat(Range &&range, size_t count,
+                   std::optional<GetIter<Range>> cut = std::nullopt) {
+  return RepeatView{std::forward<Range>(range), count, cut};
+}
@@ -0,0 +1,166 @@
+#pragma once
+#include <cstddef>
+#include <functional>
+#include <iterator>
+#include <type_traits>
+#include <utility>
+
+#include "core.h"
+
+// Scan
+
+// Running aggregates of the upstream: element i of the inclusive scan is
+// op(...op(op(init, x0), x1)..., xi), the exclusive scan starts at init and
+// stops before folding in the last element. Both have the length of the
+// upstream and apply op once per element. The aggregate lives in the
+// iterator, so it is returned by value.
+
+template <typename Range, typename BinOp, typename T, bool kExclusive>
+class ScanView : private SizedView<Range>, private FunctorWrapper<BinOp> {
+  // How iterators over It hold the functor
+  template <typename It>  //
+  using IterFunctor =
+      FunctorRef<BinOp, T, typename std::iterator_traits<It>::reference>;
+
+  template <typename Sent>  //
+  struct ScanSentinel {
+    Sent end;
+  };
+
+  template <typename It, typename Sent>  //
+  struct ScanIterator : private IterFunctor<It> {
+    using iterator_category = std::forward_iterator_tag;
+    using value_type = T;
+    using difference_type = typename std::iterator_traits<It>::difference_type;
+    using reference = T;
+    using pointer = T const *;
+
+    ScanIterator(FunctorWrapper<BinOp> &op, It i, Sent e, T init)
+        : IterFunctor<It>(op),
+          it(std::move(i)),
+          end(std::move(e)),
+          acc(std::move(init)) {
+      if constexpr (!kExclusive) {
+        if (it != end) {
+          acc = Apply();
+        }
+      }
+    }
+
+    reference operator*() const { return acc; }
+
+    ScanIterator &operator++() {
+      if constexpr (kExclusive) {
+        acc = Apply();
+        ++it;
+      } else if (++it != end) {
+        acc = Apply();
+      }
+      return *this;
+    }
+
+    ScanIterator operator++(int)  // NOLINT
+    {
+      auto tmp = *this;
+      ++*this;
+      return tmp;
+    }
+
+    bool operator==(const ScanIterator &rhs) const { return it == rhs.it; }
+    bool operator!=(const ScanIterator &rhs) const { return !(*this == rhs); }
+
+    bool operator==(const ScanSentinel<Sent> &rhs) const {
+      return it == rhs.end;
+    }
+    bool operator!=(const ScanSentinel<Sent> &rhs) const {
+      return !(*this == rhs);
+    }
+
+    T Apply() { return IterFunctor<It>::operator()(std::move(acc), *it); }
+
+    It it;
+    Sent end;
+    T acc;
+  };
+
+ public:
+  using iterator = ScanIterator<GetIter<Range>, GetSentinel<Range>>;
+  using sentinel = ScanSentinel<GetSentinel<Range>>;
+
+  iterator begin()  // NOLINT
+  {
+    return {static_cast<FunctorWrapper<BinOp> &>(*this),
+            SizedView<Range>::begin(), SizedView<Range>::end(), _init};
+  }
+
+  sentinel end()  // NOLINT
+  {
+    return {SizedView<Range>::end()};
+  }
+
+  using SizedView<Range>::size;
+  using SizedView<Range>::Hint;
+
+  using SizedView<Range>::Base;
+
+  template <typename B, typename I>
+  explicit ScanView(Range &range, B &&op, I &&init)
+      : SizedView<Range>(range),
+        FunctorWrapper<BinOp>(std::forward<B>(op)),
+        _init(std::forward<I>(init)) {}
+
+ private:
+  T _init;
+};
+
+template <typename Range, typename BinOp, typename T, bool kExclusive>
+struct IsView<ScanView<Range, BinOp, T, kExclusive>> : std::true_type {};
+template <typename Range, typename BinOp, typename T, bool kExclusive>
+struct IsSized<ScanView<Range, BinOp, T, kExclusive>> : IsSized<Range> {};
+template <typename Range, typename BinOp, typename T, bool kExclusive>
+struct BorrowsView<ScanView<Range, BinOp, T, kExclusive>>
+    : std::disjunction<
+          std::negation<IsInlineFunctor<
+              BinOp, T,
+              typename std::iterator_traits<GetIter<Range>>::reference>>,
+          BorrowsView<std::decay_t<Range>>> {};
+
+namespace ranges {
+template <typename BinOp, typename T, bool kExclusive = false>
+struct Scan : private FunctorWrapper<BinOp> {
+  template <typename Range>  //
+  auto operator()(Range &&range) {
+    return ScanView<Range, BinOp, T, kExclusive>{range, Functor(), _init};
+  }
+
+  FunctorWrapper<BinOp> &Functor() { return *this; }
+
+  explicit Scan(BinOp op, T init)
+      : FunctorWrapper<BinOp>(std::move(op)), _init(std::move(init)) {}
+
+ private:
+  T _init;
+};
+template <typename BinOp, typename T>
+Scan(BinOp, T) -> Scan<BinOp, T>;
+
+template <typename BinOp, typename T>
+struct ExclusiveScan : Scan<BinOp, T, true> {
+  explicit ExclusiveScan(BinOp op, T init)
+      : Scan<BinOp, T, true>(std::move(op), std::move(init)) {}
+};
+template <typename BinOp, typename T>
+ExclusiveScan(BinOp, T) -> ExclusiveScan<BinOp, T>;
+}  // namespace ranges
+
+template <typename Range, typename BinOp, typename T>  //
+inline auto Scan(Range &&range, BinOp &&op, T &&init) {
+  return ranges::Scan(std::forward<BinOp>(op), std::forward<T>(init))(
+      std::forward<Range>(range));
+}
+
+template <typename Range, typename BinOp, typename T>  //
+inline auto ExclusiveScan(Range &&range, BinOp &&op, T &&init) {
+  return ranges::ExclusiveScan(std::forward<BinOp>(op), std::forward<T>(init))(
+      std::forward<Range>(range));
+}
@@ -0,0 +1,172 @@
+#pragma once
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <limits>
+#include <memory>
+#include <mutex>
+#include <optional>
+#include <utility>
+#include <vector>
+
+#include "core.h"
+
+// SnapshotSource
+
+// Immutable versions of a vector shared between one writer and many reader
+// threads with epoch based reclamation. Every reader thread registers once
+// and pins the current version for the lifetime of its pipeline, a pin only
+// announces the global epoch in the reader's own slot. Publish never waits
+// for readers, a retired version is freed once every pinned reader has
+// announced a later epoch.
+
+namespace ranges::detail {
+struct alignas(64) SnapshotSlot {
+  std::atomic<uint64_t> epoch{0};
+  std::atomic<bool> used{false};
+  size_t pins = 0;  // Owned by the reader thread
+};
+}  // namespace ranges::detail
+
+template <typename T>
+class SnapshotSource;
+
+// Keeps the pinned version alive, copies share the pin of their reader
+template <typename T>  //
+class SnapshotView : public SizedView<std::vector<T> const> {
+  using Slot = ranges::detail::SnapshotSlot;
+  using Version = std::vector<T> const;
+
+ public:
+  SnapshotView(SnapshotView const &other)
+      : SizedView<Version>(other), _slot(other._slot) {
+    ++_slot->pins;
+  }
+
+  SnapshotView &operator=(SnapshotView const &) = delete;
+
+  ~SnapshotView() {
+    if (--_slot->pins == 0) {
+      _slot->epoch.store(0);
+    }
+  }
+
+ private:
+  friend class SnapshotSource<T>;
+
+  SnapshotView(Slot *slot, std::atomic<uint64_t> &epoch,
+               std::atomic<Version *> &current)
+      : SizedView<Version>(Acquire(slot, epoch, current)), _slot(slot) {}
+
+  // The epoch has to be announced before the version is loaded
+  static Version &Acquire(Slot *slot, std::atomic<uint64_t> &epoch,
+                          std::atomic<Version *> &current) {
+    if (slot->pins++ == 0) {
+      slot->epoch.store(epoch.load());
+    }
+    return *current.load();
+  }
+
+  Slot *_slot;
+};
+
+template <typename T>
+struct IsView<SnapshotView<T>> : std::true_type {};
+template <typename T>
+struct IsSized<SnapshotView<T>> : std::true_type {};
+
+template <typename T>
+class SnapshotSource {
+  using Slot = ranges::detail::SnapshotSlot;
+  using Version = std::vector<T> const;
+
+  struct Retired {
+    std::unique_ptr<Version> version;
+    uint64_t epoch;
+  };
+
+ public:
+  // Thread affine handle to a reader slot
+  class Reader {
+   public:
+    Reader(Reader &&other) noexcept
+        : _source(std::exchange(other._source, nullptr)), _slot(other._slot) {}
+
+    Reader(Reader const &) = delete;
+    Reader &operator=(Reader const &) = delete;
+    Reader &operator=(Reader &&) = delete;
+
+    ~Reader() {
+      if (_source != nullptr) {
+        _slot->used.store(false);
+      }
+    }
+
+    SnapshotView<T> Pin() {
+      return SnapshotView<T>{_slot, _source->_epoch, _source->_current};
+    }
+
+   private:
+    friend class SnapshotSource;
+
+    Reader(SnapshotSource *source, Slot *slot) : _source(source), _slot(slot) {}
+
+    SnapshotSource *_source;
+    Slot *_slot;
+  };
+
+  // Nothing is returned when all reader slots are taken
+  std::optional<Reader> Register() {
+    for (size_t i = 0; i < _readers; ++i) {
+      bool expected = false;
+      if (_slots[i].used.compare_exchange_strong(expected, true)) {
+        return Reader{this, &_slots[i]};
+      }
+    }
+    return std::nullopt;
+  }
+
+  void Publish(std::vector<T> data) {
+    auto next = std::make_unique<Version>(std::move(data));
+    std::lock_guard lock{_writer};
+    std::unique_ptr<Version> prev{_current.exchange(next.release())};
+    _retired.push_back({std::move(prev), _epoch.fetch_add(1)});
+    ReclaimRetired();
+  }
+
+  // Frees the retired versions no reader can still observe
+  void Reclaim() {
+    std::lock_guard lock{_writer};
+    ReclaimRetired();
+  }
+
+  explicit SnapshotSource(std::vector<T> data, size_t readers = 64)
+      : _current(new Version(std::move(data))),
+        _slots(std::make_unique<Slot[]>(readers)),
+        _readers(readers) {}
+
+  SnapshotSource(SnapshotSource const &) = delete;
+  SnapshotSource &operator=(SnapshotSource const &) = delete;
+
+  ~SnapshotSource() { delete _current.load(); }
+
+ private:
+  void ReclaimRetired() {
+    auto oldest = std::numeric_limits<uint64_t>::max();
+    for (size_t i = 0; i < _readers; ++i) {
+      if (auto epoch = _slots[i].epoch.load(); epoch != 0) {
+        oldest = std::min(oldest, epoch);
+      }
+    }
+    std::erase_if(_retired, [&](auto &&retired) {  //
+      return retired.epoch < oldest;
+    });
+  }
+
+  std::atomic<Version *> _current;
+  std::atomic<uint64_t> _epoch{1};
+  std::unique_ptr<Slot[]> _slots;
+  size_t _readers;
+  std::mutex _writer;
+  std::vector<Retired> _retired;
+};
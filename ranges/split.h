@@ -0,0 +1,168 @@
+#pragma once
+#include <array>
+#include <cassert>
+#include <cstddef>
+#include <cstring>
+#include <iterator>
+#include <memory>
+#include <string>
+#include <string_view>
+
+#include "core.h"
+
+// Split, Lines
+
+// Tokens of a text as std::string_views into it, nothing is copied or
+// allocated, so the text (a std::string, a mapped file) must outlive them. A
+// single character delimiter is searched with memchr, which the C library
+// vectorizes; longer ones with string_view::find. Split yields one token more
+// than there are delimiters, Lines drops the empty line after a final newline
+// and a carriage return before each newline. An empty text has no tokens.
+// Delimiters of up to kInlineDelim characters are kept inline, in the view
+// and in each iterator, longer ones in a string the view and its iterators
+// share, so iterators stay valid when the view is moved.
+
+class SplitView {
+ public:
+  static constexpr size_t kInlineDelim = 15;
+
+ private:
+  // Short delimiters held by value, longer ones shared
+  struct Delimiter {
+    explicit Delimiter(std::string_view delim) : size(delim.size()) {
+      if (size <= kInlineDelim) {
+        std::memcpy(chars.data(), delim.data(), size);
+      } else {
+        owned = std::make_shared<std::string const>(delim);
+      }
+    }
+
+    std::string_view View() const {
+      return owned ? std::string_view{*owned}
+                   : std::string_view{chars.data(), size};
+    }
+
+    std::array<char, kInlineDelim> chars{};
+    size_t size;
+    std::shared_ptr<std::string const> owned;
+  };
+
+  struct SplitSentinel {};
+
+  struct SplitIterator {
+    using iterator_category = std::forward_iterator_tag;
+    using value_type = std::string_view;
+    using difference_type = std::ptrdiff_t;
+    using reference = std::string_view;
+    using pointer = std::string_view const *;
+
+    reference operator*() const {
+      auto size = static_cast<size_t>(stop - token);
+      if (lines && size > 0 && stop[-1] == '\r') {
+        --size;
+      }
+      return {token, size};
+    }
+
+    SplitIterator &operator++() {
+      if (stop == end) {
+        token = nullptr;
+        return *this;
+      }
+      token = stop + delim.size;
+      if (lines && token == end) {
+        token = nullptr;
+        return *this;
+      }
+      stop = Find(token);
+      return *this;
+    }
+
+    SplitIterator operator++(int)  // NOLINT
+    {
+      auto tmp = *this;
+      ++*this;
+      return tmp;
+    }
+
+    bool operator==(const SplitIterator &rhs) const {
+      return token == rhs.token && stop == rhs.stop;
+    }
+    bool operator!=(const SplitIterator &rhs) const { return !(*this == rhs); }
+
+    bool operator==(const SplitSentinel &) const { return token == nullptr; }
+    bool operator!=(const SplitSentinel &) const { return token != nullptr; }
+
+    // Next delimiter from at, or the end of the text
+    char const *Find(char const *at) const {
+      if (delim.size == 1) {
+        auto *found = static_cast<char const *>(
+            std::memchr(at, delim.chars[0], static_cast<size_t>(end - at)));
+        return found == nullptr ? end : found;
+      }
+      std::string_view rest{at, static_cast<size_t>(end - at)};
+      auto found = rest.find(delim.View());
+      return found == std::string_view::npos ? end : at + found;
+    }
+
+    char const *token;
+    char const *stop;
+    char const *end;
+    Delimiter delim;
+    bool lines;
+  };
+
+ public:
+  using iterator = SplitIterator;
+  using sentinel = SplitSentinel;
+
+  iterator begin() const  // NOLINT
+  {
+    auto *end = _text.data() + _text.size();
+    if (_text.empty()) {
+      return {nullptr, nullptr, end, _delim, _lines};
+    }
+    iterator it{_text.data(), nullptr, end, _delim, _lines};
+    it.stop = it.Find(it.token);
+    return it;
+  }
+
+  sentinel end() const  // NOLINT
+  {
+    return {};
+  }
+
+  typename iterator::difference_type size() const  // NOLINT
+  {
+    return ranges::detail::SizeOf(*this);
+  }
+
+  // Any upper bound would be far too large to reserve
+  SizeHint Hint() const { return {_text.empty() ? 0U : 1U, std::nullopt}; }
+
+  explicit SplitView(std::string_view text, std::string_view delim,
+                     bool lines = false)
+      : _text(text), _delim(delim), _lines(lines) {
+    assert(!delim.empty());
+  }
+
+ private:
+  std::string_view _text;
+  Delimiter _delim;
+  bool _lines;
+};
+
+template <>
+struct IsView<SplitView> : std::true_type {};
+
+inline SplitView Split(std::string_view text, std::string_view delim) {
+  return SplitView{text, delim};
+}
+
+inline SplitView Split(std::string_view text, char delim) {
+  return SplitView{text, std::string_view{&delim, 1}};
+}
+
+inline SplitView Lines(std::string_view text) {
+  return SplitView{text, "\n", true};
+}
@@ -0,0 +1,152 @@
+#pragma once
+#include <algorithm>
+#include <cstddef>
+
+#include "core.h"
+
+//  Take
+
+template <typename Range, typename = void>  //
+class TakeView : private SizedView<Range> {
+  template <typename Sent>  //
+  struct TakeSentinel {
+    Sent end;
+  };
+
+  template <typename It>
+  struct TakeIterator {
+    using iterator_category = std::forward_iterator_tag;
+    using value_type = typename It::value_type;
+    using difference_type = typename It::difference_type;
+    using reference = typename It::reference;
+    using pointer = typename It::pointer;
+
+    reference operator*() { return *it; }
+
+    TakeIterator &operator++() {
+      --left;
+      ++it;
+      return *this;
+    }
+
+    TakeIterator operator++(int)  // NOLINT
+    {
+      auto tmp = *this;
+      ++*this;
+      return tmp;
+    }
+
+    bool operator==(const TakeIterator &rhs) const {
+      return left == rhs.left && it == rhs.it;
+    }
+
+    bool operator!=(const TakeIterator &rhs) const { return !(*this == rhs); }
+
+    template <typename Sent>  //
+    bool operator==(const TakeSentinel<Sent> &rhs) const {
+      return left == 0 || it == rhs.end;
+    }
+    template <typename Sent>  //
+    bool operator!=(const TakeSentinel<Sent> &rhs) const {
+      return !(*this == rhs);
+    }
+
+    TakeIterator(It i, difference_type l) : it(i), left(l) {}
+
+    It it;
+    difference_type left;
+  };
+
+ public:
+  using iterator = TakeIterator<GetIter<Range>>;
+  using sentinel = TakeSentinel<GetSentinel<Range>>;
+
+  iterator begin()  // NOLINT
+  {
+    return {SizedView<Range>::begin(), _count};
+  }
+
+  sentinel end()  // NOLINT
+  {
+    return {SizedView<Range>::end()};
+  }
+
+  typename iterator::difference_type size() const  // NOLINT
+  {
+    return ranges::detail::SizeOf(*this);
+  }
+
+  SizeHint Hint() const {
+    return SizedView<Range>::Hint().Cap(static_cast<size_t>(_count));
+  }
+
+  using SizedView<Range>::Base;
+  typename iterator::difference_type Count() const { return _count; }
+
+  explicit TakeView(Range &range, typename iterator::difference_type count)
+      : SizedView<Range>(range),  //
+        _count(count) {}
+
+ private:
+  typename iterator::difference_type _count;
+};
+
+template <typename Range>  //
+class TakeView<Range, std::enable_if_t<IsRandomAccess<Range>::value>>
+    : private SizedView<Range> {
+ public:
+  using iterator = GetIter<Range>;
+
+  using SizedView<Range>::begin;
+
+  typename iterator::difference_type size() const  // NOLINT
+  {
+    return std::min(SizedView<Range>::size(), _count);
+  }
+
+  iterator end()  // NOLINT
+  {
+    return begin() + size();
+  }
+
+  SizeHint Hint() const {
+    return SizeHint::Exactly(static_cast<size_t>(size()));
+  }
+
+  using SizedView<Range>::Base;
+  typename iterator::difference_type Count() const { return _count; }
+
+  explicit TakeView(Range &range, typename iterator::difference_type count)
+      : SizedView<Range>(range),  //
+        _count(count) {}
+
+ private:
+  typename iterator::difference_type _count;
+};
+
+template <typename Rng>  //
+TakeView(Rng &&, size_t)
+    -> TakeView<Rng, std::enable_if_t<IsRandomAccess<Rng>::value>>;
+
+template <typename Range>
+struct IsView<TakeView<Range>> : std::true_type {};
+template <typename Range>
+struct IsSized<TakeView<Range>> : IsSized<Range> {};
+
+namespace ranges {
+struct Take {
+  template <typename Range>  //
+  auto operator()(Range &&range) {
+    return TakeView{range, _count};
+  }
+
+  explicit Take(std::ptrdiff_t count) : _count(count) {}
+
+  std::ptrdiff_t _count;
+};
+}  // namespace ranges
+
+template <typename Range>  //
+inline auto Take(Range &&range, std::ptrdiff_t count) {
+  return ranges::Take{count}(std::forward<Range>(range));
+}
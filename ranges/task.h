@@ -0,0 +1,147 @@
+#pragma once
+#include <condition_variable>
+#include <coroutine>
+#include <mutex>
+#include <optional>
+#include <utility>
+
+// Task
+
+namespace ranges::detail {
+template <typename T>
+struct TaskResult {
+  void return_value(T value) { result.emplace(std::move(value)); }
+  T Take() { return std::move(*result); }
+
+  std::optional<T> result;
+};
+
+template <>
+struct TaskResult<void> {
+  void return_void() noexcept {}
+  void Take() noexcept {}
+};
+
+// Resumes whoever awaited the finished coroutine
+struct ContinuationAwaiter {
+  bool await_ready() const noexcept { return false; }
+  template <typename Promise>
+  std::coroutine_handle<> await_suspend(
+      std::coroutine_handle<Promise> handle) noexcept {
+    return handle.promise().continuation;
+  }
+  void await_resume() const noexcept {}
+};
+}  // namespace ranges::detail
+
+// Lazily started coroutine, runs when awaited and resumes the awaiter when
+// done
+template <typename T = void>
+class Task {
+ public:
+  struct promise_type : ranges::detail::TaskResult<T> {
+    Task get_return_object() {
+      return Task{std::coroutine_handle<promise_type>::from_promise(*this)};
+    }
+
+    std::suspend_always initial_suspend() noexcept { return {}; }
+    ranges::detail::ContinuationAwaiter final_suspend() noexcept { return {}; }
+    void unhandled_exception() noexcept { std::terminate(); }
+
+    std::coroutine_handle<> continuation = std::noop_coroutine();
+  };
+
+  bool await_ready() const noexcept { return false; }
+
+  std::coroutine_handle<> await_suspend(std::coroutine_handle<> awaiter) {
+    _handle.promise().continuation = awaiter;
+    return _handle;
+  }
+
+  T await_resume() { return _handle.promise().Take(); }
+
+  Task(Task &&other) noexcept : _handle(std::exchange(other._handle, {})) {}
+
+  Task(Task const &) = delete;
+  Task &operator=(Task const &) = delete;
+  Task &operator=(Task &&) = delete;
+
+  ~Task() {
+    if (_handle) {
+      _handle.destroy();
+    }
+  }
+
+ private:
+  explicit Task(std::coroutine_handle<promise_type> handle) : _handle(handle) {}
+
+  std::coroutine_handle<promise_type> _handle;
+};
+
+namespace ranges::detail {
+// Signals the blocked SyncWait caller once the awaited task is done
+struct SyncWaitTask {
+  struct promise_type {
+    SyncWaitTask get_return_object() {
+      return {std::coroutine_handle<promise_type>::from_promise(*this)};
+    }
+
+    std::suspend_always initial_suspend() noexcept { return {}; }
+
+    auto final_suspend() noexcept {
+      struct Notify {
+        bool await_ready() const noexcept { return false; }
+        void await_suspend(
+            std::coroutine_handle<promise_type> handle) noexcept {
+          auto &&promise = handle.promise();
+          std::lock_guard lock{*promise.mutex};
+          *promise.done = true;
+          promise.cv->notify_one();
+        }
+        void await_resume() const noexcept {}
+      };
+      return Notify{};
+    }
+
+    void return_void() noexcept {}
+    void unhandled_exception() noexcept { std::terminate(); }
+
+    std::mutex *mutex;
+    std::condition_variable *cv;
+    bool *done;
+  };
+
+  std::coroutine_handle<promise_type> handle;
+};
+
+template <typename T>
+SyncWaitTask Drive(Task<T> &task, TaskResult<T> &out) {
+  if constexpr (std::is_void_v<T>) {
+    co_await task;
+  } else {
+    out.return_value(co_await task);
+  }
+}
+}  // namespace ranges::detail
+
+// Blocks the calling thread until the task, and everything it awaits, is done
+template <typename T>
+T SyncWait(Task<T> task) {
+  ranges::detail::TaskResult<T> out;
+  std::mutex mutex;
+  std::condition_variable cv;
+  bool done = false;
+
+  auto driver = ranges::detail::Drive(task, out);
+  auto &&promise = driver.handle.promise();
+  promise.mutex = &mutex;
+  promise.cv = &cv;
+  promise.done = &done;
+  driver.handle.resume();
+  {
+    std::unique_lock lock{mutex};
+    cv.wait(lock, [&] { return done; });
+  }
+  driver.handle.destroy();
+  return out.Take();
+}
@@ -0,0 +1,335 @@
+#pragma once
+#include <cstddef>
+#include <functional>
+#include <optional>
+#include <tuple>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+#include "core.h"
+#include "filter.h"
+#include "filter_map.h"
+#include "map.h"
+#include "terminals.h"
+
+// Tee
+
+// Drives several terminals from a single traversal: every element is handed
+// to each sink in turn and the results come back as a tuple, in sink order.
+// Sinks are Collect, ForEach, and the Fold, Len, Max and Min sinks below.
+// On a range of their own those forward to the free functions of the same
+// name, so only a Tee walks the range through the sinks. Branch puts a Map,
+// Filter or FilterMap stage in front of a sink, so sinks can see different
+// downstream pipelines of the same pass.
+
+namespace ranges {
+template <typename Acc, typename BinOp>
+struct Fold : private FunctorWrapper<BinOp> {
+  template <typename Range>  //
+  Acc operator()(Range &&range);
+
+  FunctorWrapper<BinOp> &Functor() { return *this; }
+
+  explicit Fold(Acc acc, BinOp op)
+      : FunctorWrapper<BinOp>(std::move(op)), init(std::move(acc)) {}
+
+  Acc init;
+};
+
+struct Len {
+  template <typename Range>  //
+  std::ptrdiff_t operator()(Range &&range);
+};
+
+// Empty when there are no elements
+template <typename Cmp = std::less<>>
+struct Max {
+  template <typename Range>  //
+  std::optional<GetValueType<Range>> operator()(Range &&range);
+
+  [[no_unique_address]] Cmp cmp;
+};
+template <typename Cmp>
+Max(Cmp) -> Max<Cmp>;
+
+// Empty when there are no elements
+template <typename Cmp = std::less<>>
+struct Min {
+  template <typename Range>  //
+  std::optional<GetValueType<Range>> operator()(Range &&range);
+
+  [[no_unique_address]] Cmp cmp;
+};
+template <typename Cmp>
+Min(Cmp) -> Min<Cmp>;
+
+template <typename Stage, typename Sink>
+struct Branch {
+  explicit Branch(Stage s, Sink k) : stage(std::move(s)), sink(std::move(k)) {}
+
+  Stage stage;
+  Sink sink;
+};
+}  // namespace ranges
+
+namespace ranges::detail {
+template <typename Container, typename T>
+class CollectSink {
+  // Targets without push_back are built from a buffer by Collect, so they
+  // get the same bulk construction
+  using Buffer = std::conditional_t<HasPushBack<Container>::value, Container,
+                                    std::vector<T>>;
+
+ public:
+  explicit CollectSink(SizeHint hint) {
+    if constexpr (HasReserve<Buffer>::value) {
+      _buffer.reserve(hint.Reservation());
+    }
+  }
+
+  template <typename E>  //
+  void Push(E &&element) {
+    _buffer.push_back(std::forward<E>(element));
+  }
+
+  Container Finish() {
+    if constexpr (std::is_same_v<Buffer, Container>) {
+      return std::move(_buffer);
+    } else {
+      return ranges::Collect<Container>{}(View{_buffer});
+    }
+  }
+
+ private:
+  Buffer _buffer;
+};
+
+template <typename Func>
+class ForEachSink {
+ public:
+  explicit ForEachSink(FunctorWrapper<Func> &func) : _func(&func) {}
+
+  template <typename E>  //
+  void Push(E &&element) {
+    (*_func)(std::forward<E>(element));
+  }
+
+  FunctorWrapper<Func> Finish() { return *_func; }
+
+ private:
+  FunctorWrapper<Func> *_func;
+};
+
+template <typename Acc, typename BinOp>
+class FoldSink {
+ public:
+  explicit FoldSink(ranges::Fold<Acc, BinOp> &fold)
+      : _op(&fold.Functor()), _acc(fold.init) {}
+
+  template <typename E>  //
+  void Push(E &&element) {
+    _acc = (*_op)(std::move(_acc), std::forward<E>(element));
+  }
+
+  Acc Finish() { return std::move(_acc); }
+
+ private:
+  FunctorWrapper<BinOp> *_op;
+  Acc _acc;
+};
+
+class LenSink {
+ public:
+  template <typename E>  //
+  void Push(E &&) {
+    ++_count;
+  }
+
+  std::ptrdiff_t Finish() const { return _count; }
+
+ private:
+  std::ptrdiff_t _count = 0;
+};
+
+// Keeps the first of equivalent elements, like Max and Min do
+template <typename T, typename Better>
+class BestSink {
+ public:
+  explicit BestSink(Better better) : _better(std::move(better)) {}
+
+  template <typename E>  //
+  void Push(E &&element) {
+    if (!_best.has_value() || _better(element, *_best)) {
+      _best.emplace(std::forward<E>(element));
+    }
+  }
+
+  std::optional<T> Finish() { return std::move(_best); }
+
+ private:
+  [[no_unique_address]] Better _better;
+  std::optional<T> _best;
+};
+
+template <typename Inner, typename Apply>
+class BranchSink {
+ public:
+  BranchSink(Inner inner, Apply apply)
+      : _inner(std::move(inner)), _apply(std::move(apply)) {}
+
+  template <typename E>  //
+  void Push(E &&element) {
+    _apply(_inner, std::forward<E>(element));
+  }
+
+  auto Finish() { return _inner.Finish(); }
+
+ private:
+  Inner _inner;
+  [[no_unique_address]] Apply _apply;
+};
+
+// Sink state for elements of type T, reserved from the hint where it helps
+template <typename T, typename Rng>
+auto StartSink(ranges::Collect<Rng> &, SizeHint hint) {
+  using Container = std::conditional_t<std::is_same_v<Rng, CollectGuard>,
+                                       std::vector<T>, std::decay_t<Rng>>;
+  return CollectSink<Container, T>{hint};
+}
+
+template <typename T, typename Func>
+auto StartSink(ranges::ForEach<Func> &for_each, SizeHint) {
+  return ForEachSink<Func>{for_each.Functor()};
+}
+
+template <typename T, typename Acc, typename BinOp>
+auto StartSink(ranges::Fold<Acc, BinOp> &fold, SizeHint) {
+  return FoldSink<Acc, BinOp>{fold};
+}
+
+template <typename T>
+auto StartSink(ranges::Len &, SizeHint) {
+  return LenSink{};
+}
+
+template <typename T, typename Cmp>
+auto StartSink(ranges::Max<Cmp> &max, SizeHint) {
+  auto better = [cmp = max.cmp](auto const &a, auto const &b) {
+    return cmp(b, a);
+  };
+  return BestSink<T, decltype(better)>{better};
+}
+
+template <typename T, typename Cmp>
+auto StartSink(ranges::Min<Cmp> &min, SizeHint) {
+  auto better = [cmp = min.cmp](auto const &a, auto const &b) {
+    return cmp(a, b);
+  };
+  return BestSink<T, decltype(better)>{better};
+}
+
+template <typename T, typename UnaryOp, typename Sink>
+auto StartSink(ranges::Branch<ranges::Map<UnaryOp>, Sink> &branch,
+               SizeHint hint) {
+  using U = std::decay_t<std::invoke_result_t<FunctorWrapper<UnaryOp> &, T &>>;
+  auto &func = branch.stage.Functor();
+  return BranchSink{StartSink<U>(branch.sink, hint),
+                    [&func](auto &inner, auto &&element) {
+                      inner.Push(func(element));
+                    }};
+}
+
+template <typename T, typename Pred, typename Sink>
+auto StartSink(ranges::Branch<ranges::Filter<Pred>, Sink> &branch,
+               SizeHint hint) {
+  auto &pred = branch.stage.Functor();
+  return BranchSink{StartSink<T>(branch.sink, hint.Subset()),
+                    [&pred](auto &inner, auto &&element) {
+                      if (pred(element)) {
+                        inner.Push(element);
+                      }
+                    }};
+}
+
+template <typename T, typename Func, typename Sink>
+auto StartSink(ranges::Branch<ranges::FilterMap<Func>, Sink> &branch,
+               SizeHint hint) {
+  using U = typename std::decay_t<
+      std::invoke_result_t<FunctorWrapper<Func> &, T &>>::value_type;
+  auto &func = branch.stage.Functor();
+  return BranchSink{StartSink<U>(branch.sink, hint.Subset()),
+                    [&func](auto &inner, auto &&element) {
+                      if (auto value = func(element)) {
+                        inner.Push(*std::move(value));
+                      }
+                    }};
+}
+
+// Runs sinks over range in a single pass, a tuple of their results
+template <typename Range, typename... Sinks>
+auto Drive(Range &range, Sinks &...sinks) {
+  using T = GetValueType<Range>;
+  auto hint = GetSizeHint(range);
+  std::tuple states{StartSink<T>(sinks, hint)...};
+  for (auto it = std::begin(range), end = std::end(range); it != end; ++it) {
+    auto &&element = *it;
+    std::apply([&](auto &...state) { (state.Push(element), ...); }, states);
+  }
+  return std::apply(
+      [](auto &...state) { return std::tuple{state.Finish()...}; }, states);
+}
+}  // namespace ranges::detail
+
+namespace ranges {
+template <typename Acc, typename BinOp>
+template <typename Range>
+Acc Fold<Acc, BinOp>::operator()(Range &&range) {
+  return ::Fold(range, init, Functor());
+}
+
+template <typename Range>
+std::ptrdiff_t Len::operator()(Range &&range) {
+  return static_cast<std::ptrdiff_t>(::Len(range));
+}
+
+template <typename Cmp>
+template <typename Range>
+std::optional<GetValueType<Range>> Max<Cmp>::operator()(Range &&range) {
+  if (std::begin(range) == std::end(range)) {
+    return std::nullopt;
+  }
+  return ::Max(range, cmp);
+}
+
+template <typename Cmp>
+template <typename Range>
+std::optional<GetValueType<Range>> Min<Cmp>::operator()(Range &&range) {
+  if (std::begin(range) == std::end(range)) {
+    return std::nullopt;
+  }
+  return ::Min(range, cmp);
+}
+
+template <typename... Sinks>
+struct Tee {
+  template <typename Range>  //
+  auto operator()(Range &&range) {
+    return std::apply(
+        [&](auto &...sinks) { return detail::Drive(range, sinks...); },
+        _sinks);
+  }
+
+  explicit Tee(Sinks... sinks) : _sinks(std::move(sinks)...) {}
+
+ private:
+  std::tuple<Sinks...> _sinks;
+};
+template <typename... Sinks>
+Tee(Sinks...) -> Tee<Sinks...>;
+}  // namespace ranges
+
+template <typename Range, typename... Sinks>  //
+inline auto Tee(Range &&range, Sinks... sinks) {
+  return ranges::Tee(std::move(sinks)...)(std::forward<Range>(range));
+}
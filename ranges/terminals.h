@@ -0,0 +1,682 @@
+#pragma once
+#include <algorithm>
+#include <cassert>
+#include <cstring>
+#include <functional>
+#include <iterator>
+#include <memory>
+#include <optional>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+#include "core.h"
+#include "containers.h"
+#include "filter.h"
+#include "pipeline.h"
+
+// Terminal Combinators
+
+namespace ranges {
+
+namespace detail {
+struct CollectGuard {};
+
+// Nothing runs while walking a container or a view straight over one, so
+// counting the elements first is cheap
+template <typename Range>
+struct IsPlain : std::negation<IsView<Range>> {};
+template <typename Range>
+struct IsPlain<View<Range>> : std::negation<IsView<Range>> {};
+template <typename Range>
+struct IsPlain<Range &> : IsPlain<std::remove_reference_t<Range>> {};
+
+// Iterators into a temporary view that they point back into would dangle,
+// such views are held in a variable by the caller
+template <typename Range>
+struct CanReturnIterator
+    : std::bool_constant<std::is_lvalue_reference_v<Range> ||
+                         !BorrowsView<std::decay_t<Range>>::value> {};
+}  // namespace detail
+
+template <typename Rng = detail::CollectGuard>
+struct Collect {
+  template <typename Range>  //
+  auto operator()(Range &&input_range) {
+    using Container =
+        std::conditional_t<std::is_same_v<Rng, detail::CollectGuard>,
+                           std::vector<GetValueType<Range>>, std::decay_t<Rng>>;
+    if constexpr (detail::IsEncodable<Container, Range>::value) {
+      return Container::Encode(input_range);
+    } else {
+      return Fill<Container>(input_range);
+    }
+  }
+
+ private:
+  // Growable targets are reserved from the size hint: the exact size or the
+  // upper bound when known, a count pass over plain ranges, otherwise the
+  // lower bound and geometric growth past it. Ordered trees are built from a
+  // sorted buffer, hash containers are sized from the hint once.
+  template <typename Container, typename Range>  //
+  Container Fill(Range &input_range) {
+    Container output_range{};
+    if constexpr (detail::HasPushBack<Container>::value &&
+                  detail::HasReserve<Container>::value) {
+      auto hint = GetSizeHint(input_range);
+      if constexpr (detail::IsPlain<Range>::value &&
+                    std::forward_iterator<GetIter<Range>>) {
+        if (!hint.upper.has_value()) {
+          hint = SizeHint::Exactly(static_cast<size_t>(
+              Distance(std::begin(input_range), std::end(input_range))));
+        }
+      }
+      output_range.reserve(hint.Reservation());
+      this->template Transfer<Container>(
+          input_range, std::back_insert_iterator{output_range});
+    } else if constexpr (detail::HasPushBack<Container>::value) {
+      this->template Transfer<Container>(
+          input_range, std::back_insert_iterator{output_range});
+    } else if constexpr (detail::HasKeyComp<Container>::value) {
+      // Every node goes in at the rightmost position, constant time instead
+      // of a descent. The stable sort keeps the first of equal keys first.
+      // Below about a thousand elements the tree stays in cache and sorting
+      // costs more than the descents it saves.
+      constexpr size_t kBulkBuild = 1024;
+      if (GetSizeHint(input_range).upper.value_or(kBulkBuild) < kBulkBuild) {
+        for (auto it = std::begin(input_range), end = std::end(input_range);
+             it != end; ++it) {
+          output_range.emplace_hint(output_range.end(), *it);
+        }
+        return output_range;
+      }
+      using Element = typename detail::Sortable<Container>::type;
+      auto buffer = Fill<std::vector<Element>>(input_range);
+      auto comp = output_range.key_comp();
+      std::stable_sort(buffer.begin(), buffer.end(),
+                       [&](auto const &lhs, auto const &rhs) {
+                         if constexpr (detail::HasMapped<Container>::value) {
+                           return comp(lhs.first, rhs.first);
+                         } else {
+                           return comp(lhs, rhs);
+                         }
+                       });
+      for (auto &&element : buffer) {
+        output_range.emplace_hint(output_range.end(), std::move(element));
+      }
+    } else if constexpr (detail::HasReserve<Container>::value) {
+      output_range.reserve(GetSizeHint(input_range).Reservation());
+      this->template Transfer<Container>(
+          input_range, std::inserter(output_range, std::end(output_range)));
+    } else {
+      this->template Transfer<Container>(
+          input_range, std::inserter(output_range, std::end(output_range)));
+    }
+    return output_range;
+  }
+
+  template <typename Dest, typename Src, typename It>  //
+  void Transfer(Src &src, It dest) {
+    if constexpr (!std::is_same_v<GetIter<Src>, GetSentinel<Src>>) {
+      for (auto it = std::begin(src), end = std::end(src); it != end; ++it) {
+        if constexpr (std::is_copy_constructible_v<GetValueType<Dest>>) {
+          *dest = *it;
+        } else {
+          *dest = std::move(*it);
+        }
+        ++dest;
+      }
+    } else if constexpr (std::is_copy_constructible_v<GetValueType<Dest>>) {
+      std::copy(std::begin(src), std::end(src), dest);
+    } else {
+      std::move(std::begin(src), std::end(src), dest);
+    }
+  }
+
+  template <typename Dest, typename Src, typename It>  //
+  void Transfer(
+      Src &src, It dest,
+      std::enable_if_t<!std::is_same_v<GetValueType<Src>, GetValueType<Dest>>> =
+          {}) {
+    if constexpr (std::is_copy_constructible_v<GetValueType<Dest>>) {
+      std::transform(std::begin(src), std::end(src), dest, [](auto const &e) {
+        return static_cast<GetValueType<Dest>>(e);  //
+      });
+    } else {
+      std::transform(std::begin(src), std::end(src), dest, [](auto &&e) {
+        return static_cast<GetValueType<Dest> &&>(
+            std::forward<decltype(e)>(e));  //
+      });
+    }
+  }
+};
+
+}  // namespace ranges
+
+template <typename OutputRange, typename InputRange>  //
+inline OutputRange Collect(InputRange &&input_range) {
+  return ranges::Collect<OutputRange>()(std::forward<InputRange>(input_range));
+}
+
+namespace ranges {
+template <typename Func>
+struct ForEach : private FunctorWrapper<Func> {
+  template <typename Range>  //
+  auto operator()(Range &&input_range) {
+    auto &&func = static_cast<FunctorWrapper<Func> &>(*this);
+    for (auto it = input_range.begin(), end = input_range.end(); it != end;
+         ++it) {
+      func(*it);
+    }
+    return func;
+  }
+
+  FunctorWrapper<Func> &Functor() { return *this; }
+
+  explicit ForEach(Func &&c) : FunctorWrapper<Func>(std::move(c)) {}
+  explicit ForEach(Func const &c) : FunctorWrapper<Func>(c) {}
+};
+}  // namespace ranges
+
+template <typename Range, typename Function>  //
+inline auto ForEach(Range &&input_range, Function &&cb) {
+  return ranges::ForEach(std::forward<Function>(cb))(
+      std::forward<Range>(input_range));
+}
+
+// O(1) when the size hint is exact, a walk otherwise
+template <typename Range>  //
+inline typename GetIter<Range>::difference_type Len(Range &&range) {
+  if (auto hint = GetSizeHint(range); hint.Exact()) {
+    return static_cast<typename GetIter<Range>::difference_type>(hint.lower);
+  }
+  return Distance(range.begin(), range.end());
+}
+
+// Never walks: the exact size, else the upper bound, else the lower bound
+template <typename Range>  //
+inline typename GetIter<Range>::difference_type LazyLen(Range &&range) {
+  return static_cast<typename GetIter<Range>::difference_type>(
+      GetSizeHint(range).Reservation());
+}
+
+template <typename Range, typename Acc, typename BinOp>  //
+inline Acc Fold(Range &&range, Acc acc, BinOp &&op) {
+  for (auto it = range.begin(), end = range.end(); it != end; ++it) {
+    acc = std::invoke(op, std::move(acc), *it);
+  }
+  return acc;
+}
+
+template <
+    typename Range, typename T,
+    typename = std::enable_if_t<
+        std::is_convertible_v<std::remove_cv_t<std::remove_reference_t<T>>,
+                              GetValueType<Range>> &&
+        !ranges::detail::HasFind<Range, T>::value>>
+GetIter<Range> Find(Range &&range, T &&val) {
+  static_assert(ranges::detail::CanReturnIterator<Range>::value,
+                "the iterator would point into a temporary view");
+  auto it = range.begin();
+  for (auto end = range.end(); it != end && !(*it == val); ++it) {
+  }
+  return it;
+}
+
+template <
+    typename Range, typename T,
+    typename = std::enable_if_t<
+        std::is_convertible_v<std::remove_cv_t<std::remove_reference_t<T>>,
+                              GetValueType<Range>> &&
+        !ranges::detail::HasCount<Range, T>::value>>
+size_t Count(Range &&range, T &&val) {
+  size_t count = 0;
+  for (auto it = range.begin(), end = range.end(); it != end; ++it) {
+    count += *it == val ? 1 : 0;
+  }
+  return count;
+}
+
+template <typename Range, typename Pred>  //
+GetIter<Range> FindIf(Range &&range, Pred &&pred) {
+  static_assert(ranges::detail::CanReturnIterator<Range>::value,
+                "the iterator would point into a temporary view");
+  auto it = range.begin();
+  for (auto end = range.end(); it != end && !std::invoke(pred, *it); ++it) {
+  }
+  return it;
+}
+
+template <typename Range, typename Pred>  //
+GetIter<Range> FindFirst(Range &&range, Pred &&pred) {
+  static_assert(ranges::detail::CanReturnIterator<Range>::value,
+                "the iterator would point into a temporary view");
+  auto &&end = std::end(range);
+  auto &&it = std::begin(range);
+  for (; it != end; ++it) {
+    if (std::invoke(std::forward<Pred>(pred), *it)) {
+      return it;
+    }
+  }
+  return it;
+}
+
+struct First {
+  template <typename A, typename B>  //
+  A const &operator()(std::pair<A, B> const &val) {
+    return val.first;
+  }
+};
+
+struct Second {
+  template <typename A, typename B>  //
+  B const &operator()(std::pair<A, B> const &val) {
+    return val.second;
+  }
+};
+
+template <typename Range, typename T, typename Proj>  //
+GetIter<Range> Find(Range &&range, T &&val, Proj proj) {
+  static_assert(ranges::detail::CanReturnIterator<Range>::value,
+                "the iterator would point into a temporary view");
+  return FindIf(range, [&](auto &&elem) {  //
+    return std::invoke(proj, std::forward<decltype(elem)>(elem)) == val;
+  });
+}
+
+template <typename Range, typename T>
+bool Contains(Range &&range, T &&val) {
+  return Find(range, val) != std::end(range);
+}
+
+template <typename Range, typename T, typename Proj>
+bool Contains(Range &&range, T &&val, Proj proj) {
+  return Find(range, std::forward<T>(val), proj) != std::end(range);
+}
+
+// Extrema
+
+// Every element is dereferenced and projected once, the best value so far is
+// kept instead of its iterator, so a view's functor never runs twice for the
+// same element. Ties go to the first element. Contiguous sources of integers
+// compared with std::less or std::greater are reduced without looking at
+// positions, in a form the compiler turns into vector min / max.
+
+namespace ranges::detail {
+template <typename Cmp, typename T>
+struct IsLessOrGreater
+    : std::disjunction<std::is_same<Cmp, std::less<>>,
+                       std::is_same<Cmp, std::less<T>>,
+                       std::is_same<Cmp, std::greater<>>,
+                       std::is_same<Cmp, std::greater<T>>> {};
+
+template <typename Range, typename Cmp, typename Proj>
+struct IsLaneReducible
+    : std::conjunction<
+          std::bool_constant<std::contiguous_iterator<GetIter<Range>>>,
+          std::is_same<GetIter<Range>, GetSentinel<Range>>,
+          std::is_integral<GetValueType<Range>>,
+          std::is_same<Proj, std::identity>,
+          IsLessOrGreater<Cmp, GetValueType<Range>>> {};
+
+// With vector min / max for T on the target a plain reduction vectorizes,
+// otherwise independent lanes at least break up the dependency chain
+template <typename T>
+constexpr bool kVectorMinMax =
+#if defined(__AVX512VL__)
+    true;
+#elif defined(__SSE4_1__) || defined(__ARM_NEON)
+    sizeof(T) < 8;
+#else
+    false;
+#endif
+
+// Smallest and largest of a non empty array
+template <bool kMin, bool kMax, typename T>
+std::pair<T, T> ReduceLanes(T const *data, size_t size) {
+  if constexpr (kVectorMinMax<T>) {
+    T low = data[0];
+    T high = data[0];
+    for (size_t i = 1; i < size; ++i) {
+      if constexpr (kMin) {
+        low = std::min(low, data[i]);
+      }
+      if constexpr (kMax) {
+        high = std::max(high, data[i]);
+      }
+    }
+    return {low, high};
+  }
+  constexpr size_t kLanes = 64 / sizeof(T);
+  T low[kLanes];
+  T high[kLanes];
+  std::fill_n(low, kLanes, data[0]);
+  std::fill_n(high, kLanes, data[0]);
+  size_t i = 0;
+  for (; i + kLanes <= size; i += kLanes) {
+    for (size_t lane = 0; lane < kLanes; ++lane) {
+      if constexpr (kMin) {
+        low[lane] = std::min(low[lane], data[i + lane]);
+      }
+      if constexpr (kMax) {
+        high[lane] = std::max(high[lane], data[i + lane]);
+      }
+    }
+  }
+  for (; i < size; ++i) {
+    low[0] = std::min(low[0], data[i]);
+    high[0] = std::max(high[0], data[i]);
+  }
+  return {*std::min_element(low, low + kLanes),
+          *std::max_element(high, high + kLanes)};
+}
+
+// Lane reduced min and max under cmp, with std::greater the roles swap
+template <typename Cmp, bool kMin, bool kMax, typename Range>
+std::pair<GetValueType<Range>, GetValueType<Range>> ReduceLanes(Range &range) {
+  constexpr bool greater =
+      std::is_same_v<Cmp, std::greater<>> ||
+      std::is_same_v<Cmp, std::greater<GetValueType<Range>>>;
+  auto *data = std::to_address(std::begin(range));
+  auto size = static_cast<size_t>(std::end(range) - std::begin(range));
+  if constexpr (greater) {
+    auto [low, high] = ReduceLanes<kMax, kMin>(data, size);
+    return {high, low};
+  } else {
+    return ReduceLanes<kMin, kMax>(data, size);
+  }
+}
+
+// Best element and its position, better(a, b) tells whether key a beats b.
+// With the identity projection the element is its own key.
+template <typename Range, typename Better, typename Proj>
+auto Best(Range &range, Better better, Proj &proj)
+    -> std::pair<GetIter<Range>, std::optional<GetValueType<Range>>> {
+  auto it = std::begin(range);
+  auto end = std::end(range);
+  if (it == end) {
+    return {it, std::nullopt};
+  }
+  auto best_it = it;
+  std::optional<GetValueType<Range>> best{*it};
+  if constexpr (std::is_same_v<Proj, std::identity>) {
+    for (++it; it != end; ++it) {
+      auto &&value = *it;
+      if (better(value, *best)) {
+        best = std::forward<decltype(value)>(value);
+        best_it = it;
+      }
+    }
+  } else {
+    std::decay_t<std::invoke_result_t<Proj &, GetValueType<Range> &>> key =
+        std::invoke(proj, *best);
+    for (++it; it != end; ++it) {
+      auto &&value = *it;
+      auto &&candidate = std::invoke(proj, value);
+      if (better(candidate, key)) {
+        key = std::forward<decltype(candidate)>(candidate);
+        best = std::forward<decltype(value)>(value);
+        best_it = it;
+      }
+    }
+  }
+  return {best_it, std::move(best)};
+}
+}  // namespace ranges::detail
+
+template <typename Range, typename Cmp = std::less<>,
+          typename Proj = std::identity>
+inline GetValueType<Range> Max(Range &&range, Cmp cmp = {}, Proj proj = {}) {
+  if constexpr (ranges::detail::IsLaneReducible<Range, Cmp, Proj>::value) {
+    assert(std::begin(range) != std::end(range));
+    return ranges::detail::ReduceLanes<Cmp, false, true>(range).second;
+  } else {
+    auto best = ranges::detail::Best(
+        range, [&](auto &&a, auto &&b) { return cmp(b, a); }, proj);
+    assert(best.second.has_value());
+    return *std::move(best.second);
+  }
+}
+
+template <typename Range, typename Cmp = std::less<>,
+          typename Proj = std::identity>
+inline GetValueType<Range> Min(Range &&range, Cmp cmp = {}, Proj proj = {}) {
+  if constexpr (ranges::detail::IsLaneReducible<Range, Cmp, Proj>::value) {
+    assert(std::begin(range) != std::end(range));
+    return ranges::detail::ReduceLanes<Cmp, true, false>(range).first;
+  } else {
+    auto best = ranges::detail::Best(
+        range, [&](auto &&a, auto &&b) { return cmp(a, b); }, proj);
+    assert(best.second.has_value());
+    return *std::move(best.second);
+  }
+}
+
+// Min and Max in a single pass
+template <typename Range, typename Cmp = std::less<>,
+          typename Proj = std::identity>
+inline std::pair<GetValueType<Range>, GetValueType<Range>> MinMax(
+    Range &&range, Cmp cmp = {}, Proj proj = {}) {
+  if constexpr (ranges::detail::IsLaneReducible<Range, Cmp, Proj>::value) {
+    assert(std::begin(range) != std::end(range));
+    return ranges::detail::ReduceLanes<Cmp, true, true>(range);
+  } else {
+    auto it = std::begin(range);
+    auto end = std::end(range);
+    assert(it != end);
+    GetValueType<Range> low = *it;
+    GetValueType<Range> high = low;
+    std::decay_t<std::invoke_result_t<Proj &, GetValueType<Range> &>>
+        low_key = std::invoke(proj, low);
+    auto high_key = low_key;
+    for (++it; it != end; ++it) {
+      auto &&value = *it;
+      auto &&key = std::invoke(proj, value);
+      if (cmp(key, low_key)) {
+        low_key = key;
+        low = value;
+      }
+      if (cmp(high_key, key)) {
+        high_key = key;
+        high = value;
+      }
+    }
+    return {std::move(low), std::move(high)};
+  }
+}
+
+// Position of the first largest element, end for an empty range
+template <typename Range, typename Cmp = std::less<>,
+          typename Proj = std::identity>
+inline GetIter<Range> ArgMax(Range &&range, Cmp cmp = {}, Proj proj = {}) {
+  static_assert(ranges::detail::CanReturnIterator<Range>::value,
+                "the iterator would point into a temporary view");
+  if constexpr (ranges::detail::IsLaneReducible<Range, Cmp, Proj>::value) {
+    if (std::begin(range) == std::end(range)) {
+      return std::begin(range);
+    }
+    return std::find(std::begin(range), std::end(range),
+                     ranges::detail::ReduceLanes<Cmp, false, true>(range)
+                         .second);
+  } else {
+    return ranges::detail::Best(
+               range, [&](auto &&a, auto &&b) { return cmp(b, a); }, proj)
+        .first;
+  }
+}
+
+// Position of the first smallest element, end for an empty range
+template <typename Range, typename Cmp = std::less<>,
+          typename Proj = std::identity>
+inline GetIter<Range> ArgMin(Range &&range, Cmp cmp = {}, Proj proj = {}) {
+  static_assert(ranges::detail::CanReturnIterator<Range>::value,
+                "the iterator would point into a temporary view");
+  if constexpr (ranges::detail::IsLaneReducible<Range, Cmp, Proj>::value) {
+    if (std::begin(range) == std::end(range)) {
+      return std::begin(range);
+    }
+    return std::find(std::begin(range), std::end(range),
+                     ranges::detail::ReduceLanes<Cmp, true, false>(range)
+                         .first);
+  } else {
+    return ranges::detail::Best(
+               range, [&](auto &&a, auto &&b) { return cmp(a, b); }, proj)
+        .first;
+  }
+}
+
+// Comparisons
+
+// Both ranges are walked together once and the walk stops at the first
+// difference, so a view's functor runs at most once per element. Ranges
+// whose size hints cannot agree are unequal without a walk. Contiguous ranges
+// of the same integer, enum or pointer type are compared as bytes.
+
+namespace ranges::detail {
+template <typename T>
+struct IsBytewise : std::disjunction<std::is_integral<T>, std::is_enum<T>,
+                                     std::is_pointer<T>> {};
+
+template <typename Range>
+struct IsContiguous
+    : std::conjunction<
+          std::bool_constant<std::contiguous_iterator<GetIter<Range>>>,
+          std::is_same<GetIter<Range>, GetSentinel<Range>>> {};
+
+template <typename RngL, typename RngR, typename Pred>
+struct IsBytewiseEqual
+    : std::conjunction<
+          IsContiguous<RngL>, IsContiguous<RngR>,
+          std::is_same<GetValueType<RngL>, GetValueType<RngR>>,
+          IsBytewise<GetValueType<RngL>>,
+          std::disjunction<
+              std::is_same<Pred, std::equal_to<>>,
+              std::is_same<Pred, std::equal_to<GetValueType<RngL>>>>> {};
+
+// memcmp orders unsigned bytes the way std::less does
+template <typename RngL, typename RngR, typename Cmp>
+struct IsBytewiseLess
+    : std::conjunction<
+          IsBytewiseEqual<RngL, RngR, std::equal_to<>>,
+          std::bool_constant<sizeof(GetValueType<RngL>) == 1>,
+          std::is_unsigned<GetValueType<RngL>>,
+          std::disjunction<std::is_same<Cmp, std::less<>>,
+                           std::is_same<Cmp, std::less<GetValueType<RngL>>>>> {
+};
+
+template <typename Range>  //
+inline auto ExactSize(Range &&range) {
+  return static_cast<size_t>(std::end(range) - std::begin(range));
+}
+
+// Index of the first difference among the first size elements. memcmp skips
+// equal blocks, only the block that differs is searched element by element.
+template <typename T>  //
+inline size_t MismatchBytes(T const *lhs, T const *rhs, size_t size) {
+  constexpr size_t kBlock = std::max<size_t>(1024 / sizeof(T), 1);
+  size_t index = 0;
+  while (index < size) {
+    size_t block = std::min(kBlock, size - index);
+    if (std::memcmp(lhs + index, rhs + index, block * sizeof(T)) != 0) {
+      break;
+    }
+    index += block;
+  }
+  while (index < size && lhs[index] == rhs[index]) {
+    ++index;
+  }
+  return index;
+}
+}  // namespace ranges::detail
+
+// Positions of the first pair of elements that differ, either may be the end
+template <typename RngL, typename RngR, typename Pred = std::equal_to<>>
+inline std::pair<GetIter<RngL>, GetIter<RngR>> Mismatch(RngL &&lhs,
+                                                        RngR &&rhs,
+                                                        Pred pred = {}) {
+  auto lit = std::begin(lhs);
+  auto rit = std::begin(rhs);
+  if constexpr (ranges::detail::IsBytewiseEqual<RngL, RngR, Pred>::value) {
+    using ranges::detail::ExactSize;
+    auto size = std::min(ExactSize(lhs), ExactSize(rhs));
+    auto index = static_cast<std::ptrdiff_t>(ranges::detail::MismatchBytes(
+        std::to_address(lit), std::to_address(rit), size));
+    return {lit + index, rit + index};
+  } else {
+    auto lend = std::end(lhs);
+    auto rend = std::end(rhs);
+    while (lit != lend && rit != rend && std::invoke(pred, *lit, *rit)) {
+      ++lit;
+      ++rit;
+    }
+    return {lit, rit};
+  }
+}
+
+template <typename RngL, typename RngR, typename Pred = std::equal_to<>>
+inline bool Equal(RngL &&lhs, RngR &&rhs, Pred pred = {}) {
+  auto lhint = GetSizeHint(lhs);
+  auto rhint = GetSizeHint(rhs);
+  if (lhint.lower > rhint.upper.value_or(lhint.lower) ||
+      rhint.lower > lhint.upper.value_or(rhint.lower)) {
+    return false;
+  }
+  if constexpr (ranges::detail::IsBytewiseEqual<RngL, RngR, Pred>::value) {
+    return lhint.lower == 0 ||
+           std::memcmp(std::to_address(std::begin(lhs)),
+                       std::to_address(std::begin(rhs)),
+                       lhint.lower * sizeof(GetValueType<RngL>)) == 0;
+  }
+  auto [lit, rit] = Mismatch(lhs, rhs, std::move(pred));
+  return lit == std::end(lhs) && rit == std::end(rhs);
+}
+
+// Whether lhs orders before rhs, a proper prefix orders first
+template <typename RngL, typename RngR, typename Cmp = std::less<>>
+inline bool LexCompare(RngL &&lhs, RngR &&rhs, Cmp cmp = {}) {
+  using ranges::detail::ExactSize;
+  if constexpr (ranges::detail::IsBytewiseLess<RngL, RngR, Cmp>::value) {
+    auto lsize = ExactSize(lhs);
+    auto rsize = ExactSize(rhs);
+    auto size = std::min(lsize, rsize);
+    int order = size == 0 ? 0
+                          : std::memcmp(std::to_address(std::begin(lhs)),
+                                        std::to_address(std::begin(rhs)),
+                                        size);
+    return order != 0 ? order < 0 : lsize < rsize;
+  } else if constexpr (
+      // Only equal integers are equivalent, the first mismatch decides
+      ranges::detail::IsBytewiseEqual<RngL, RngR, std::equal_to<>>::value &&
+      ranges::detail::IsLessOrGreater<Cmp, GetValueType<RngL>>::value) {
+    auto [lit, rit] = Mismatch(lhs, rhs);
+    if (rit == std::end(rhs)) {
+      return false;
+    }
+    return lit == std::end(lhs) || cmp(*lit, *rit);
+  } else {
+    auto lit = std::begin(lhs);
+    auto rit = std::begin(rhs);
+    auto lend = std::end(lhs);
+    auto rend = std::end(rhs);
+    for (; rit != rend; ++lit, ++rit) {
+      if (lit == lend) {
+        return true;
+      }
+      auto &&left = *lit;
+      auto &&right = *rit;
+      if (std::invoke(cmp, left, right)) {
+        return true;
+      }
+      if (std::invoke(cmp, right, left)) {
+        return false;
+      }
+    }
+    return false;
+  }
+}
+
+template <typename RngL, typename RngR>  //
+inline auto Difference(RngL &&lhs, RngR &&rhs) {
+  return std::forward<RngL>(lhs)  //
+         | ranges::Filter([&](auto &&elem) { return !Contains(rhs, elem); });
+}
@@ -0,0 +1,87 @@
+#pragma once
+#include <algorithm>
+#include <condition_variable>
+#include <coroutine>
+#include <cstddef>
+#include <deque>
+#include <functional>
+#include <mutex>
+#include <thread>
+#include <utility>
+#include <vector>
+
+// ThreadPool
+
+class ThreadPool {
+ public:
+  // Awaitable that resumes the awaiting coroutine on one of the workers
+  struct ScheduleAwaiter {
+    bool await_ready() const noexcept { return false; }
+    void await_suspend(std::coroutine_handle<> handle) {
+      pool->Post([handle] { handle.resume(); });
+    }
+    void await_resume() const noexcept {}
+
+    ThreadPool *pool;
+  };
+
+  void Post(std::function<void()> task) {
+    {
+      std::lock_guard lock{_mutex};
+      _tasks.push_back(std::move(task));
+    }
+    _cv.notify_one();
+  }
+
+  ScheduleAwaiter Schedule() { return {this}; }
+
+  size_t size() const  // NOLINT
+  {
+    return _workers.size();
+  }
+
+  explicit ThreadPool(
+      size_t threads = std::max(1U, std::thread::hardware_concurrency())) {
+    _workers.reserve(threads);
+    for (size_t i = 0; i < threads; ++i) {
+      _workers.emplace_back([this] { Work(); });
+    }
+  }
+
+  ThreadPool(ThreadPool const &) = delete;
+  ThreadPool &operator=(ThreadPool const &) = delete;
+
+  ~ThreadPool() {
+    {
+      std::lock_guard lock{_mutex};
+      _stop = true;
+    }
+    _cv.notify_all();
+    for (auto &&worker : _workers) {
+      worker.join();
+    }
+  }
+
+ private:
+  void Work() {
+    while (true) {
+      std::function<void()> task;
+      {
+        std::unique_lock lock{_mutex};
+        _cv.wait(lock, [this] { return _stop || !_tasks.empty(); });
+        if (_tasks.empty()) {
+          return;
+        }
+        task = std::move(_tasks.front());
+        _tasks.pop_front();
+      }
+      task();
+    }
+  }
+
+  std::mutex _mutex;
+  std::condition_variable _cv;
+  std::deque<std::function<void()>> _tasks;
+  bool _stop = false;
+  std::vector<std::thread> _workers;
+};
@@ -0,0 +1,216 @@
+#pragma once
+#include <array>
+#include <cassert>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <iterator>
+#include <tuple>
+#include <type_traits>
+#include <utility>
+#include <variant>
+#include <vector>
+
+#include "core.h"
+
+// VariantBatches
+
+// A range of std::variant split by alternative: one vector per alternative
+// holding its elements in their original relative order, and the alternative
+// index of every element. VisitBatches runs a visitor (e.g. an Overloaded)
+// over one batch after the other, so every call site sees a single type and
+// no element pays a visit dispatch. MapBatches does the same and puts the
+// results back in the original order. Iterating the batches yields the
+// variants again in the original order.
+
+namespace ranges::detail {
+template <typename Variant>
+struct BatchesOf;
+template <typename... Alternatives>
+struct BatchesOf<std::variant<Alternatives...>> {
+  using type = std::tuple<std::vector<Alternatives>...>;
+};
+}  // namespace ranges::detail
+
+template <typename Variant>
+class VariantBatches {
+  static constexpr size_t kAlternatives = std::variant_size_v<Variant>;
+  static_assert(kAlternatives <= 256, "alternative indices are bytes");
+
+  using Indices = std::make_index_sequence<kAlternatives>;
+
+  struct VariantSentinel {};
+
+  struct VariantIterator {
+    using iterator_category = std::forward_iterator_tag;
+    using value_type = Variant;
+    using difference_type = std::ptrdiff_t;
+    using reference = Variant;
+    using pointer = Variant const *;
+
+    reference operator*() const {
+      auto alternative = batches->_order[index];
+      return kRead[alternative](*batches, next[alternative]);
+    }
+
+    VariantIterator &operator++() {
+      ++next[batches->_order[index++]];
+      return *this;
+    }
+
+    VariantIterator operator++(int)  // NOLINT
+    {
+      auto tmp = *this;
+      ++*this;
+      return tmp;
+    }
+
+    bool operator==(const VariantSentinel &) const {
+      return index == batches->_order.size();
+    }
+    bool operator!=(const VariantSentinel &rhs) const {
+      return !(*this == rhs);
+    }
+
+    VariantBatches const *batches;
+    size_t index = 0;
+    std::array<size_t, kAlternatives> next{};
+  };
+
+ public:
+  using value_type = Variant;
+  using iterator = VariantIterator;
+  using sentinel = VariantSentinel;
+
+  template <size_t I>
+  using Alternative = std::variant_alternative_t<I, Variant>;
+
+  template <typename Range>  //
+  static VariantBatches Encode(Range &&range) {
+    VariantBatches batches;
+    batches._order.reserve(GetSizeHint(range).Reservation());
+    for (auto it = std::begin(range), end = std::end(range); it != end; ++it) {
+      Variant const &element = *it;
+      assert(!element.valueless_by_exception());
+      batches._order.push_back(static_cast<uint8_t>(element.index()));
+      kAppend[element.index()](batches, element);
+    }
+    return batches;
+  }
+
+  iterator begin() const  // NOLINT
+  {
+    return {this};
+  }
+
+  sentinel end() const  // NOLINT
+  {
+    return {};
+  }
+
+  size_t size() const  // NOLINT
+  {
+    return _order.size();
+  }
+
+  SizeHint Hint() const { return SizeHint::Exactly(size()); }
+
+  // Elements holding alternative I, in their original relative order
+  template <size_t I>
+  std::vector<Alternative<I>> &Batch() {
+    return std::get<I>(_batches);
+  }
+  template <size_t I>
+  std::vector<Alternative<I>> const &Batch() const {
+    return std::get<I>(_batches);
+  }
+
+  // Alternative index of every element, in the original order
+  std::vector<uint8_t> const &Order() const { return _order; }
+
+ private:
+  template <size_t I>
+  static void Append(VariantBatches &batches, Variant const &element) {
+    batches.Batch<I>().push_back(*std::get_if<I>(&element));
+  }
+
+  template <size_t I>
+  static Variant Read(VariantBatches const &batches, size_t index) {
+    return Variant{std::in_place_index<I>, batches.Batch<I>()[index]};
+  }
+
+  template <size_t... I>
+  static constexpr auto AppendTable(std::index_sequence<I...>) {
+    return std::array<void (*)(VariantBatches &, Variant const &),
+                      kAlternatives>{&Append<I>...};
+  }
+
+  template <size_t... I>
+  static constexpr auto ReadTable(std::index_sequence<I...>) {
+    return std::array<Variant (*)(VariantBatches const &, size_t),
+                      kAlternatives>{&Read<I>...};
+  }
+
+  static constexpr auto kAppend = AppendTable(Indices{});
+  static constexpr auto kRead = ReadTable(Indices{});
+
+  typename ranges::detail::BatchesOf<Variant>::type _batches;
+  std::vector<uint8_t> _order;
+};
+
+namespace ranges {
+struct Batches {
+  template <typename Range>  //
+  auto operator()(Range &&range) {
+    return VariantBatches<GetValueType<Range>>::Encode(range);
+  }
+};
+}  // namespace ranges
+
+template <typename Range>  //
+inline auto Batches(Range &&range) {
+  return ranges::Batches{}(std::forward<Range>(range));
+}
+
+// func runs over every element of the first batch, then of the second and so
+// on, not in the original order
+template <typename Variant, typename Func>  //
+inline void VisitBatches(VariantBatches<Variant> &batches, Func &&func) {
+  [&]<size_t... I>(std::index_sequence<I...>) {
+    (
+        [&] {
+          for (auto &&element : batches.template Batch<I>()) {
+            std::invoke(func, element);
+          }
+        }(),
+        ...);
+  }(std::make_index_sequence<std::variant_size_v<Variant>>{});
+}
+
+// Results of func for every element in the original order. Every batch is
+// mapped on its own, the results are then gathered through the order.
+template <typename Variant, typename Func>  //
+inline auto MapBatches(VariantBatches<Variant> &batches, Func &&func) {
+  return [&]<size_t... I>(std::index_sequence<I...>) {
+    using Result = std::common_type_t<std::decay_t<std::invoke_result_t<
+        Func &,
+        typename VariantBatches<Variant>::template Alternative<I> &>>...>;
+    std::array<std::vector<Result>, sizeof...(I)> mapped;
+    (
+        [&] {
+          auto &&batch = batches.template Batch<I>();
+          mapped[I].reserve(batch.size());
+          for (auto &&element : batch) {
+            mapped[I].push_back(std::invoke(func, element));
+          }
+        }(),
+        ...);
+    std::array<size_t, sizeof...(I)> next{};
+    std::vector<Result> output;
+    output.reserve(batches.size());
+    for (auto alternative : batches.Order()) {
+      output.push_back(std::move(mapped[alternative][next[alternative]++]));
+    }
+    return output;
+  }(std::make_index_sequence<std::variant_size_v<Variant>>{});
+}
@@ -0,0 +1,465 @@
+#pragma once
+#include <array>
+#include <cassert>
+#include <cstddef>
+#include <functional>
+#include <iterator>
+#include <memory>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+#include "core.h"
+
+// Window
+
+// One aggregate per full window of w consecutive elements, n - w + 1 of them,
+// kept up to date as the window slides instead of folding every window again.
+// The aggregate is an associative binary operation over the elements, lifted
+// first when the aggregate has a Lift (Count lifts to 0 or 1). Operations
+// with an Inverse take the leaving element back out in O(1). Every other
+// operation runs on two stacks: the older part of the window holds suffix
+// aggregates, rebuilt once every w elements, the newer part a running
+// aggregate, amortized O(1) and exact. Contiguous arithmetic inputs skip the
+// element buffer and fill a block of aggregates at a time straight from the
+// input.
+
+namespace ranges::window {
+// Invertible for integers only, floating point sums would drift
+struct Sum {
+  template <typename T>  //
+  T operator()(T const &lhs, T const &rhs) const {
+    return lhs + rhs;
+  }
+
+  template <typename T, typename = std::enable_if_t<std::is_integral_v<T>>>
+  T Inverse(T const &sum, T const &leaving) const {
+    return sum - leaving;
+  }
+};
+
+struct Min {
+  template <typename T>  //
+  T operator()(T const &lhs, T const &rhs) const {
+    return rhs < lhs ? rhs : lhs;
+  }
+};
+
+struct Max {
+  template <typename T>  //
+  T operator()(T const &lhs, T const &rhs) const {
+    return lhs < rhs ? rhs : lhs;
+  }
+};
+
+// Elements satisfying the predicate
+template <typename Pred>
+struct Count {
+  template <typename T>  //
+  size_t Lift(T const &value) const {
+    return std::invoke(pred, value) ? 1 : 0;
+  }
+
+  size_t operator()(size_t lhs, size_t rhs) const { return lhs + rhs; }
+
+  size_t Inverse(size_t count, size_t leaving) const { return count - leaving; }
+
+  Pred pred;
+};
+template <typename Pred>
+Count(Pred) -> Count<Pred>;
+}  // namespace ranges::window
+
+namespace ranges::detail {
+template <typename Agg, typename T>  //
+inline decltype(auto) Lift(Agg const &agg, T &&value) {
+  if constexpr (requires { agg.Lift(value); }) {
+    return agg.Lift(value);
+  } else {
+    return std::forward<T>(value);
+  }
+}
+
+template <typename Agg, typename T>
+using LiftResult = std::decay_t<decltype(Lift(std::declval<Agg const &>(),
+                                              std::declval<T>()))>;
+
+template <typename Agg, typename R>
+struct IsInvertible : std::bool_constant<requires(Agg const &agg, R value) {
+  agg.Inverse(value, value);
+}> {};
+
+// Running aggregate, the ring holds the elements still to leave
+template <typename Agg, typename R>
+class InvertibleWindow {
+ public:
+  explicit InvertibleWindow(size_t width) { _ring.reserve(width); }
+
+  void Push(Agg const &agg, R value) {
+    if (_ring.size() < _ring.capacity()) {
+      _sum = _ring.empty() ? value : std::invoke(agg, _sum, value);
+      _ring.push_back(std::move(value));
+      return;
+    }
+    _sum = std::invoke(agg, agg.Inverse(_sum, _ring[_next]), value);
+    _ring[_next] = std::move(value);
+    _next = _next + 1 == _ring.size() ? 0 : _next + 1;
+  }
+
+  R const &Value(Agg const &) const { return _sum; }
+
+ private:
+  std::vector<R> _ring;
+  size_t _next = 0;
+  R _sum{};
+};
+
+// Suffix aggregates of the older elements, the newer ones as they came with
+// their running aggregate. Once the older part is used up the newer elements
+// become it.
+template <typename Agg, typename R>
+class TwoStackWindow {
+ public:
+  explicit TwoStackWindow(size_t width) : _width(width) {
+    _front.reserve(width);
+    _back.reserve(width);
+  }
+
+  void Push(Agg const &agg, R value) {
+    if (_front.size() - _oldest + _back.size() == _width) {
+      if (_oldest == _front.size()) {
+        Flip(agg);
+      }
+      ++_oldest;
+    }
+    _newer = _back.empty() ? value : std::invoke(agg, _newer, value);
+    _back.push_back(std::move(value));
+  }
+
+  R Value(Agg const &agg) const {
+    if (_oldest == _front.size()) {
+      return _newer;
+    }
+    if (_back.empty()) {
+      return _front[_oldest];
+    }
+    return std::invoke(agg, _front[_oldest], _newer);
+  }
+
+ private:
+  void Flip(Agg const &agg) {
+    _front.swap(_back);
+    for (size_t i = _front.size() - 1; i-- > 0;) {
+      _front[i] = std::invoke(agg, _front[i], _front[i + 1]);
+    }
+    _back.clear();
+    _oldest = 0;
+  }
+
+  std::vector<R> _front;
+  std::vector<R> _back;
+  size_t _oldest = 0;
+  size_t _width;
+  R _newer{};
+};
+
+template <typename Agg, typename R>
+using WindowState =
+    std::conditional_t<IsInvertible<Agg, R>::value, InvertibleWindow<Agg, R>,
+                       TwoStackWindow<Agg, R>>;
+
+template <typename Range, typename Agg>
+struct IsBatchedWindow
+    : std::conjunction<
+          std::bool_constant<std::contiguous_iterator<GetIter<Range>>>,
+          std::is_same<GetIter<Range>, GetSentinel<Range>>,
+          std::is_arithmetic<GetValueType<Range>>,
+          std::is_arithmetic<LiftResult<Agg, GetIterReference<Range>>>> {};
+}  // namespace ranges::detail
+
+template <typename Range, typename Agg, typename = void>
+class WindowView : private SizedView<Range> {
+  using R = ranges::detail::LiftResult<Agg, GetIterReference<Range>>;
+
+  struct WindowSentinel {};
+
+  template <typename It, typename Sent>
+  struct WindowIterator {
+    using iterator_category = std::forward_iterator_tag;
+    using value_type = R;
+    using difference_type = typename std::iterator_traits<It>::difference_type;
+    using reference = R;
+    using pointer = R const *;
+
+    // Fills the first window, there is none when the input is shorter
+    WindowIterator(Agg const &a, It i, Sent e, size_t width)
+        : agg(&a), it(std::move(i)), end(std::move(e)), state(width) {
+      for (size_t n = 0; n < width; ++n, ++it) {
+        if (it == end) {
+          done = true;
+          return;
+        }
+        state.Push(*agg, ranges::detail::Lift(*agg, *it));
+      }
+    }
+
+    reference operator*() const { return state.Value(*agg); }
+
+    WindowIterator &operator++() {
+      if (it == end) {
+        done = true;
+      } else {
+        state.Push(*agg, ranges::detail::Lift(*agg, *it));
+        ++it;
+      }
+      return *this;
+    }
+
+    WindowIterator operator++(int)  // NOLINT
+    {
+      auto tmp = *this;
+      ++*this;
+      return tmp;
+    }
+
+    bool operator==(const WindowSentinel &) const { return done; }
+    bool operator!=(const WindowSentinel &) const { return !done; }
+
+    Agg const *agg;
+    It it;
+    Sent end;
+    ranges::detail::WindowState<Agg, R> state;
+    bool done = false;
+  };
+
+ public:
+  using iterator = WindowIterator<GetIter<Range>, GetSentinel<Range>>;
+  using sentinel = WindowSentinel;
+
+  iterator begin()  // NOLINT
+  {
+    return {_agg, SizedView<Range>::begin(), SizedView<Range>::end(), _width};
+  }
+
+  sentinel end()  // NOLINT
+  {
+    return {};
+  }
+
+  typename iterator::difference_type size() const  // NOLINT
+  {
+    return ranges::detail::SizeOf(*this);
+  }
+
+  SizeHint Hint() const {
+    auto hint = SizedView<Range>::Hint();
+    auto windows = [&](size_t size) {
+      return size < _width ? 0 : size - _width + 1;
+    };
+    if (!hint.upper.has_value()) {
+      return {windows(hint.lower), std::nullopt};
+    }
+    return {windows(hint.lower), windows(*hint.upper)};
+  }
+
+  using SizedView<Range>::Base;
+
+  template <typename A>
+  explicit WindowView(Range &range, size_t width, A &&agg)
+      : SizedView<Range>(range), _width(width), _agg(std::forward<A>(agg)) {
+    assert(width > 0);
+  }
+
+ private:
+  size_t _width;
+  Agg _agg;
+};
+
+// Blocks of aggregates are computed straight from the contiguous input into a
+// buffer held by the iterator. Between two rebuilds of the suffix aggregates
+// a window costs two applications of the operation and no branch. Aggregates
+// are returned by value, iterator copies carry the buffers along.
+template <typename Range, typename Agg>
+class WindowView<
+    Range, Agg,
+    std::enable_if_t<ranges::detail::IsBatchedWindow<Range, Agg>::value>>
+    : private SizedView<Range> {
+  using R = ranges::detail::LiftResult<Agg, GetIterReference<Range>>;
+  using T = GetValueType<Range>;
+
+  static constexpr size_t kBlock = 256;
+
+  struct WindowSentinel {
+    size_t size;
+  };
+
+  struct WindowIterator {
+    using iterator_category = std::forward_iterator_tag;
+    using value_type = R;
+    using difference_type = std::ptrdiff_t;
+    using reference = R;
+    using pointer = R const *;
+
+    WindowIterator(Agg const &a, T const *d, size_t s, size_t w)
+        : agg(&a), data(d), size(s < w ? 0 : s - w + 1), width(w) {
+      if (size > 0) {
+        if constexpr (!ranges::detail::IsInvertible<Agg, R>::value) {
+          front.resize(width);
+        }
+        Fill();
+      }
+    }
+
+    reference operator*() const { return buffer[index % kBlock]; }
+
+    WindowIterator &operator++() {
+      if (++index % kBlock == 0 && index < size) {
+        Fill();
+      }
+      return *this;
+    }
+
+    WindowIterator operator++(int)  // NOLINT
+    {
+      auto tmp = *this;
+      ++*this;
+      return tmp;
+    }
+
+    bool operator==(const WindowSentinel &rhs) const {
+      return index >= rhs.size;
+    }
+    bool operator!=(const WindowSentinel &rhs) const { return !(*this == rhs); }
+
+    R Lift(size_t at) const { return ranges::detail::Lift(*agg, data[at]); }
+
+    // Aggregates of the windows starting at index up to the end of the block
+    void Fill() {
+      size_t count = std::min(kBlock, size - index);
+      size_t k = 0;
+      if constexpr (ranges::detail::IsInvertible<Agg, R>::value) {
+        if (index == 0) {
+          running = Lift(0);
+          for (size_t i = 1; i < width; ++i) {
+            running = std::invoke(*agg, running, Lift(i));
+          }
+          buffer[k++] = running;
+        }
+        for (; k < count; ++k) {
+          size_t oldest = index + k;
+          running = std::invoke(*agg, agg->Inverse(running, Lift(oldest - 1)),
+                                Lift(oldest + width - 1));
+          buffer[k] = running;
+        }
+      } else {
+        // Windows starting at a multiple of w are a whole block of suffix
+        // aggregates, the others combine a suffix with the running aggregate
+        // of the next block
+        while (k < count) {
+          size_t offset = (index + k) % width;
+          if (offset == 0) {
+            Rebuild(index + k);
+            buffer[k++] = front[0];
+            continue;
+          }
+          if (offset == 1) {
+            running = Lift(index + k + width - 1);
+            buffer[k++] = std::invoke(*agg, front[1], running);
+            continue;
+          }
+          size_t stop = std::min(count, k + width - offset);
+          for (; k < stop; ++k, ++offset) {
+            running = std::invoke(*agg, running, Lift(index + k + width - 1));
+            buffer[k] = std::invoke(*agg, front[offset], running);
+          }
+        }
+      }
+    }
+
+    // Suffix aggregates of the w elements from begin
+    void Rebuild(size_t begin) {
+      front[width - 1] = Lift(begin + width - 1);
+      for (size_t i = width - 1; i-- > 0;) {
+        front[i] = std::invoke(*agg, Lift(begin + i), front[i + 1]);
+      }
+    }
+
+    Agg const *agg;
+    T const *data;
+    size_t size;
+    size_t width;
+    size_t index = 0;
+    R running{};
+    std::vector<R> front;
+    std::array<R, kBlock> buffer;
+  };
+
+ public:
+  using iterator = WindowIterator;
+  using sentinel = WindowSentinel;
+
+  iterator begin()  // NOLINT
+  {
+    auto first = SizedView<Range>::begin();
+    return {_agg, std::to_address(first),
+            static_cast<size_t>(SizedView<Range>::end() - first), _width};
+  }
+
+  sentinel end()  // NOLINT
+  {
+    return {static_cast<size_t>(size())};
+  }
+
+  typename iterator::difference_type size() const  // NOLINT
+  {
+    auto size = static_cast<size_t>(SizedView<Range>::size());
+    return static_cast<std::ptrdiff_t>(size < _width ? 0 : size - _width + 1);
+  }
+
+  SizeHint Hint() const { return SizeHint::Exactly(size()); }
+
+  using SizedView<Range>::Base;
+
+  template <typename A>
+  explicit WindowView(Range &range, size_t width, A &&agg)
+      : SizedView<Range>(range), _width(width), _agg(std::forward<A>(agg)) {
+    assert(width > 0);
+  }
+
+ private:
+  size_t _width;
+  Agg _agg;
+};
+
+template <typename Rng, typename A>  //
+WindowView(Rng &&, size_t, A &&) -> WindowView<Rng, std::decay_t<A>>;
+
+template <typename Range, typename Agg>
+struct IsView<WindowView<Range, Agg>> : std::true_type {};
+template <typename Range, typename Agg>
+struct IsSized<WindowView<Range, Agg>> : IsSized<Range> {};
+
+namespace ranges {
+template <typename Agg>
+struct Window {
+  template <typename Range>  //
+  auto operator()(Range &&range) {
+    return WindowView{range, _width, _agg};
+  }
+
+  explicit Window(size_t width, Agg agg = {})
+      : _width(width), _agg(std::move(agg)) {}
+
+ private:
+  size_t _width;
+  Agg _agg;
+};
+template <typename Agg>
+Window(size_t, Agg) -> Window<Agg>;
+}  // namespace ranges
+
+template <typename Range, typename Agg>  //
+inline auto Window(Range &&range, size_t width, Agg &&agg) {
+  return ranges::Window(width, std::forward<Agg>(agg))(
+      std::forward<Range>(range));
+}
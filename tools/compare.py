@@ -0,0 +1,225 @@
+#!/usr/bin/env python3
+"""Runs the ranges benchmarks and compares two runs.
+
+  compare.py run BINARY OUT.json [--repetitions N] [--filter REGEX]
+  compare.py compare BASELINE.json CONTENDER.json [--threshold PCT]
+                     [--alpha P] [--report FILE.md] [--readme README.md]
+                     [--fail-on-regression]
+
+Every benchmark is compared on the real time of its repetitions. A change
+is flagged when the Mann-Whitney U test rejects equal distributions at
+--alpha and the median moved by more than --threshold percent. The
+confidence interval of the change is a bootstrap over the repetitions.
+"""
+
+import argparse
+import json
+import math
+import random
+import re
+import statistics
+import subprocess
+import sys
+
+README_BEGIN = "<!-- benchmarks:begin -->"
+README_END = "<!-- benchmarks:end -->"
+
+TO_NS = {"ns": 1.0, "us": 1e3, "ms": 1e6, "s": 1e9}
+
+
+def run(args):
+    command = [
+        args.binary,
+        "--benchmark_repetitions=%d" % args.repetitions,
+        "--benchmark_enable_random_interleaving=true",
+        "--benchmark_filter=%s" % args.filter,
+        "--benchmark_out=%s" % args.out,
+        "--benchmark_out_format=json",
+    ]
+    return subprocess.call(command)
+
+
+def load(path):
+    """Returns the run context and real times in ns per benchmark."""
+    with open(path) as file:
+        data = json.load(file)
+    times = {}
+    for entry in data["benchmarks"]:
+        if entry.get("run_type", "iteration") != "iteration":
+            continue
+        if "error_occurred" in entry and entry["error_occurred"]:
+            continue
+        name = entry.get("run_name", entry["name"])
+        scale = TO_NS[entry.get("time_unit", "ns")]
+        times.setdefault(name, []).append(entry["real_time"] * scale)
+    return data.get("context", {}), times
+
+
+def mann_whitney(xs, ys):
+    """Two sided p-value, normal approximation with tie correction."""
+    n, m = len(xs), len(ys)
+    pooled = sorted([(value, 0) for value in xs] + [(value, 1) for value in ys])
+    ranks = [0.0] * len(pooled)
+    ties = 0.0
+    i = 0
+    while i < len(pooled):
+        j = i
+        while j + 1 < len(pooled) and pooled[j + 1][0] == pooled[i][0]:
+            j += 1
+        for k in range(i, j + 1):
+            ranks[k] = (i + j) / 2 + 1
+        count = j - i + 1
+        ties += count**3 - count
+        i = j + 1
+    rank_sum = sum(rank for rank, (_, side) in zip(ranks, pooled) if side == 0)
+    u = rank_sum - n * (n + 1) / 2
+    mean = n * m / 2
+    variance = n * m / 12 * ((n + m + 1) - ties / ((n + m) * (n + m - 1)))
+    if variance <= 0:
+        return 1.0
+    z = (abs(u - mean) - 0.5) / math.sqrt(variance)
+    return min(1.0, math.erfc(max(z, 0.0) / math.sqrt(2)))
+
+
+def bootstrap(xs, ys, confidence=0.95, rounds=2000):
+    """Interval of the relative change of the median, in percent."""
+    rng = random.Random(42)
+    changes = []
+    for _ in range(rounds):
+        base = statistics.median(rng.choices(xs, k=len(xs)))
+        new = statistics.median(rng.choices(ys, k=len(ys)))
+        changes.append((new / base - 1) * 100)
+    changes.sort()
+    tail = (1 - confidence) / 2
+    low = changes[int(tail * (rounds - 1))]
+    high = changes[int((1 - tail) * (rounds - 1))]
+    return low, high
+
+
+def format_ns(value):
+    for unit, scale in (("s", 1e9), ("ms", 1e6), ("us", 1e3)):
+        if value >= scale:
+            return "%.3g %s" % (value / scale, unit)
+    return "%.3g ns" % value
+
+
+def compare(args):
+    base_context, baseline = load(args.baseline)
+    context, contender = load(args.contender)
+
+    rows = []
+    regressions = 0
+    for name in sorted(baseline.keys() & contender.keys(), key=natural):
+        xs, ys = baseline[name], contender[name]
+        change = (statistics.median(ys) / statistics.median(xs) - 1) * 100
+        p = mann_whitney(xs, ys) if min(len(xs), len(ys)) > 1 else 1.0
+        low, high = bootstrap(xs, ys)
+        verdict = ""
+        if p < args.alpha and abs(change) > args.threshold:
+            verdict = "regression" if change > 0 else "improvement"
+        regressions += verdict == "regression"
+        rows.append((name, statistics.median(xs), statistics.median(ys),
+                     change, low, high, p, verdict, len(xs), len(ys)))
+
+    report = render(context, base_context, rows, args)
+    if args.report:
+        with open(args.report, "w") as file:
+            file.write(report)
+    if args.readme:
+        replace_section(args.readme, report)
+    if not args.report and not args.readme:
+        sys.stdout.write(report)
+
+    for row in rows:
+        if row[7]:
+            print("%s: %s %+.1f%% (p=%.3g)" % (row[0], row[7], row[3], row[6]))
+    return 1 if regressions and args.fail_on_regression else 0
+
+
+def natural(name):
+    return [int(part) if part.isdigit() else part
+            for part in re.split(r"(\d+)", name)]
+
+
+def describe(context):
+    caches = ", ".join(
+        "L%d %s %d KiB" % (cache["level"], cache["type"], cache["size"] // 1024)
+        for cache in context.get("caches", []))
+    return "%s CPUs at %s MHz, %s, benchmark library built %s" % (
+        context.get("num_cpus", "?"), context.get("mhz_per_cpu", "?"),
+        caches or "unknown caches", context.get("library_build_type", "?"))
+
+
+def render(context, base_context, rows, args):
+    lines = [
+        "Median real time over %s repetitions, change is contender against "
+        "baseline with a 95%% bootstrap interval. Flagged when the "
+        "Mann-Whitney U p-value is below %g and the median moved more than "
+        "%g%%." % (describe_repetitions(rows), args.alpha, args.threshold),
+        "",
+        "Machine: %s." % describe(context),
+    ]
+    if context.get("cpu_scaling_enabled") or base_context.get(
+            "cpu_scaling_enabled"):
+        lines.append("")
+        lines.append("**CPU frequency scaling was enabled, results are "
+                     "noisy.**")
+    lines += [
+        "",
+        "| Benchmark | Baseline | Contender | Change | 95% CI | p | |",
+        "|---|---:|---:|---:|---|---:|---|",
+    ]
+    for (name, base, new, change, low, high, p, verdict, _, _) in rows:
+        lines.append(
+            "| %s | %s | %s | %+.1f%% | [%+.1f%%, %+.1f%%] | %.3g | %s |" %
+            (name, format_ns(base), format_ns(new), change, low, high, p,
+             verdict))
+    return "\n".join(lines) + "\n"
+
+
+def describe_repetitions(rows):
+    counts = sorted({row[8] for row in rows} | {row[9] for row in rows})
+    return "/".join(str(count) for count in counts) or "0"
+
+
+def replace_section(path, report):
+    with open(path) as file:
+        text = file.read()
+    begin = text.find(README_BEGIN)
+    end = text.find(README_END)
+    if begin < 0 or end < begin:
+        raise SystemExit("%s has no %s ... %s section" %
+                         (path, README_BEGIN, README_END))
+    text = (text[:begin + len(README_BEGIN)] + "\n\n" + report + "\n" +
+            text[end:])
+    with open(path, "w") as file:
+        file.write(text)
+
+
+def main():
+    parser = argparse.ArgumentParser(description=__doc__.splitlines()[0])
+    commands = parser.add_subparsers(dest="command", required=True)
+
+    run_parser = commands.add_parser("run", help="run with repetitions")
+    run_parser.add_argument("binary")
+    run_parser.add_argument("out")
+    run_parser.add_argument("--repetitions", type=int, default=10)
+    run_parser.add_argument("--filter", default=".")
+    run_parser.set_defaults(func=run)
+
+    compare_parser = commands.add_parser("compare", help="compare two runs")
+    compare_parser.add_argument("baseline")
+    compare_parser.add_argument("contender")
+    compare_parser.add_argument("--threshold", type=float, default=5.0)
+    compare_parser.add_argument("--alpha", type=float, default=0.05)
+    compare_parser.add_argument("--report")
+    compare_parser.add_argument("--readme")
+    compare_parser.add_argument("--fail-on-regression", action="store_true")
+    compare_parser.set_defaults(func=compare)
+
+    args = parser.parse_args()
+    return args.func(args)
+
+
+if __name__ == "__main__":
+    sys.exit(main())
@@ -0,0 +1,121 @@
+#!/usr/bin/env python3
+"""Measures how long the compiler frontend takes on pipelines of growing depth.
+
+  compile_bench.py COMPILER INCLUDE_DIR [--std c++23] [--depths 1,2,4,...]
+                   [--repetitions N] [--flag FLAG ...]
+
+Every depth is compiled with -fsyntax-only through the umbrella ranges.h and
+through the lean ranges/terminals.h. The report has the median wall time,
+the time the compiler spent in template instantiation and, with Clang, the
+number of class and function instantiations taken from -ftime-trace.
+"""
+
+import argparse
+import glob
+import json
+import os
+import re
+import statistics
+import subprocess
+import sys
+import tempfile
+import time
+
+HEADERS = {"ranges.h": "ranges.h", "lean": "ranges/terminals.h"}
+
+STAGES = [
+    "ranges::Filter([](auto&& num) {{ return num % {0} != 0; }})",
+    "ranges::Map([](auto&& num) {{ return num + {0}; }})",
+    "ranges::Take({0}000)",
+]
+
+
+def source(header, depth):
+    """A Collect behind depth stages, every lambda is a distinct type."""
+    stages = "".join("\n      | " + STAGES[i % len(STAGES)].format(i + 2)
+                     for i in range(depth))
+    return ("#include <cstdint>\n"
+            "#include \"%s\"\n\n"
+            "std::vector<uint64_t> Pipeline(std::vector<uint64_t>& data) {\n"
+            "  return View{data}%s\n"
+            "      | ranges::Collect<>{};\n"
+            "}\n" % (header, stages))
+
+
+def is_clang(compiler):
+    output = subprocess.run([compiler, "--version"], capture_output=True,
+                            text=True).stdout
+    return "clang" in output
+
+
+def compile_once(args, clang, path, workdir):
+    command = [args.compiler, "-std=" + args.std, "-fsyntax-only",
+               "-I" + args.include_dir] + args.flag
+    if clang:
+        command += ["-ftime-trace", "-ftime-trace-granularity=0"]
+    else:
+        command += ["-ftime-report"]
+    start = time.perf_counter()
+    result = subprocess.run(command + [path], capture_output=True, text=True,
+                            cwd=workdir)
+    elapsed = time.perf_counter() - start
+    if result.returncode != 0:
+        sys.stderr.write(result.stderr)
+        raise SystemExit("compiling %s failed" % path)
+
+    instantiation, count = None, None
+    if clang:
+        traces = glob.glob(os.path.join(workdir, "*.json"))
+        with open(traces[0]) as file:
+            events = json.load(file)["traceEvents"]
+        for trace in traces:
+            os.remove(trace)
+        names = [event.get("name") for event in events]
+        count = sum(name in ("InstantiateClass", "InstantiateFunction")
+                    for name in names)
+        for event in events:
+            if event.get("name") == "Total PerformPendingInstantiations":
+                instantiation = event["dur"] / 1e6
+    else:
+        match = re.search(r"template instantiation\s*:.*?([\d.]+)\s*\(\s*\d+%\)"
+                          r"\s*[\d.]+[kMG]?\s*\(", result.stderr)
+        if match:
+            instantiation = float(match.group(1))
+    return elapsed, instantiation, count
+
+
+def main():
+    parser = argparse.ArgumentParser(description=__doc__.splitlines()[0])
+    parser.add_argument("compiler")
+    parser.add_argument("include_dir")
+    parser.add_argument("--std", default="c++23")
+    parser.add_argument("--depths", default="1,2,4,8,16,32")
+    parser.add_argument("--repetitions", type=int, default=3)
+    parser.add_argument("--flag", action="append", default=[])
+    args = parser.parse_args()
+
+    clang = is_clang(args.compiler)
+    print("| Header | Depth | Frontend | Instantiation | Instantiations |")
+    print("|---|---:|---:|---:|---:|")
+    with tempfile.TemporaryDirectory() as workdir:
+        for name, header in HEADERS.items():
+            for depth in map(int, args.depths.split(",")):
+                path = os.path.join(workdir, "depth%d.cpp" % depth)
+                with open(path, "w") as file:
+                    file.write(source(header, depth))
+                runs = [compile_once(args, clang, path, workdir)
+                        for _ in range(args.repetitions)]
+                elapsed = statistics.median(run[0] for run in runs)
+                instantiation = [run[1] for run in runs if run[1] is not None]
+                count = runs[0][2]
+                print("| %s | %d | %.2f s | %s | %s |" % (
+                    name, depth, elapsed,
+                    "%.2f s" % statistics.median(instantiation)
+                    if instantiation else "n/a",
+                    count if count is not None else "n/a"))
+                sys.stdout.flush()
+    return 0
+
+
+if __name__ == "__main__":
+    sys.exit(main())